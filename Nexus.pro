@@ -0,0 +1,9 @@
+# The application with its tests, "make check" runs the tests
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    app \
+    tests
+
+app.file = Nexus_3_0.pro
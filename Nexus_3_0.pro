@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui xml
+QT       += core gui xml concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -29,11 +29,25 @@ SOURCES += \
         mainwindow.cpp \
     tableview.cpp \
     point.cpp \
+    pointstore.cpp \
+    stringpool.cpp \
     loader.cpp \
+    loadpipeline.cpp \
+    loadprogress.cpp \
+    bytescanner.cpp \
+    mappedfile.cpp \
+    dbidparser.cpp \
+    dbidtree.cpp \
+    dbidpatch.cpp \
+    planttopology.cpp \
+    srctokenizer.cpp \
+    srcmatcher.cpp \
+    filterrule.cpp \
+    wildcardmask.cpp \
+    kksindex.cpp \
     pointstablemodel.cpp \
     pointssortfilterproxymodel.cpp \
     treemodel.cpp \
-    treeitem.cpp \
     srcbgproxymodel.cpp \
     excelpointsmodel.cpp \
     comparemodel.cpp \
@@ -44,11 +58,25 @@ HEADERS += \
     threadrunner.h \
     tableview.h \
     point.h \
+    pointstore.h \
+    stringpool.h \
     loader.h \
+    loadpipeline.h \
+    loadprogress.h \
+    bytescanner.h \
+    mappedfile.h \
+    dbidparser.h \
+    dbidtree.h \
+    dbidpatch.h \
+    planttopology.h \
+    srctokenizer.h \
+    srcmatcher.h \
+    filterrule.h \
+    wildcardmask.h \
+    kksindex.h \
     pointstablemodel.h \
     pointssortfilterproxymodel.h \
     treemodel.h \
-    treeitem.h \
     srcbgproxymodel.h \
     excelpointsmodel.h \
     globalsettings.h \
@@ -0,0 +1,145 @@
+#include "bytescanner.h"
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define BYTESCANNER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+  struct Needles {
+    char bytes[3];
+    int count;
+  };
+
+  inline bool matches(char ch, const Needles& needles) {
+    for (int i = 0; i < needles.count; ++i) {
+      if (ch == needles.bytes[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int findScalar(const char* data, int from, int to, const Needles& needles) {
+    for (auto pos = from; pos < to; ++pos) {
+      if (matches(data[pos], needles)) {
+        return pos;
+      }
+    }
+    return -1;
+  }
+
+#ifdef BYTESCANNER_X86
+  __attribute__((target("sse2")))
+  int findSse2(const char* data, int from, int to, const Needles& needles) {
+    __m128i masks[3];
+    for (int i = 0; i < needles.count; ++i) {
+      masks[i] = _mm_set1_epi8(needles.bytes[i]);
+    }
+    auto pos = from;
+    for (; pos + 16 <= to; pos += 16) {
+      auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+      auto found = _mm_cmpeq_epi8(block, masks[0]);
+      for (int i = 1; i < needles.count; ++i) {
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(block, masks[i]));
+      }
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(found));
+      if (bits != 0) {
+        return pos + __builtin_ctz(bits);
+      }
+    }
+    return findScalar(data, pos, to, needles);
+  }
+
+  __attribute__((target("avx2")))
+  int findAvx2(const char* data, int from, int to, const Needles& needles) {
+    __m256i masks[3];
+    for (int i = 0; i < needles.count; ++i) {
+      masks[i] = _mm256_set1_epi8(needles.bytes[i]);
+    }
+    auto pos = from;
+    for (; pos + 32 <= to; pos += 32) {
+      auto block =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+      auto found = _mm256_cmpeq_epi8(block, masks[0]);
+      for (int i = 1; i < needles.count; ++i) {
+        found = _mm256_or_si256(found, _mm256_cmpeq_epi8(block, masks[i]));
+      }
+      auto bits = static_cast<unsigned>(_mm256_movemask_epi8(found));
+      if (bits != 0) {
+        return pos + __builtin_ctz(bits);
+      }
+    }
+    return findSse2(data, pos, to, needles);
+  }
+#endif
+
+  using FindFunction = int (*)(const char*, int, int, const Needles&);
+
+  FindFunction selectFind() {
+#ifdef BYTESCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return findAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return findSse2;
+    }
+#endif
+    return findScalar;
+  }
+
+  int findNeedles(const char* data, int from, int to, const Needles& needles) {
+    static const auto find_function = selectFind();
+    if (from >= to) {
+      return -1;
+    }
+    return find_function(data, from, to, needles);
+  }
+
+}
+
+int ByteScanner::find(const char* data, int from, int to, char ch) {
+  return findNeedles(data, from, to, {{ch}, 1});
+}
+
+int ByteScanner::findAny(const char* data,
+                         int from,
+                         int to,
+                         char first,
+                         char second) {
+  return findNeedles(data, from, to, {{first, second}, 2});
+}
+
+int ByteScanner::findAny(const char* data,
+                         int from,
+                         int to,
+                         char first,
+                         char second,
+                         char third) {
+  return findNeedles(data, from, to, {{first, second, third}, 3});
+}
+
+int ByteScanner::find(const char* data,
+                      int from,
+                      int to,
+                      const char* text,
+                      int size) {
+  if (size == 0) {
+    return from <= to ? from : -1;
+  }
+  auto last_from = to - size + 1;
+  auto pos = from;
+  while ((pos = find(data, pos, last_from, text[0])) != -1) {
+    if (std::memcmp(data + pos + 1, text + 1,
+                    static_cast<size_t>(size - 1)) == 0) {
+      return pos;
+    }
+    ++pos;
+  }
+  return -1;
+}
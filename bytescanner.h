@@ -0,0 +1,18 @@
+#pragma once
+
+// Byte delimiter search over raw file contents. The SSE2/AVX2 kernels are
+// picked at run time, other targets fall back to a scalar loop. All
+// functions look in [from, to) and return the position found or -1.
+namespace ByteScanner {
+
+  int find(const char* data, int from, int to, char ch);
+  int findAny(const char* data, int from, int to, char first, char second);
+  int findAny(const char* data,
+              int from,
+              int to,
+              char first,
+              char second,
+              char third);
+  int find(const char* data, int from, int to, const char* text, int size);
+
+}
@@ -34,54 +34,7 @@ void CompareModel::runComparition() {
 bool CompareModel::filterAcceptsRow
 (int source_row, [[maybe_unused]] const QModelIndex &source_parent) const
 {
-  auto model = sourceModel();
-  auto compareModelCount = compareModelData->m_tableModelList.size();
-  for (int i = 0; i < compareModelData->m_parameterList.size(); ++i) {
-    auto value = QVariant();
-    for (int j = 0; j < compareModelCount; ++j) {
-      if (compareModelData->m_tableModelList[j]->rowCount() != 0) {
-        auto stringValue
-            = model->data(model->index(source_row,
-                                       1 + i * compareModelCount + j))
-                                 .toString();
-        bool convOk = false;
-        auto doubleValue = QString::number(stringValue.toDouble(&convOk));
-        if (value.isValid()) {
-          if ((convOk && value != doubleValue)
-              || (!convOk && value != stringValue)) {
-            return true;
-          }
-        } else {
-          if (convOk) {
-            value = doubleValue;
-          } else {
-            value = stringValue;
-          }
-        }
-      }
-
-//    auto firstValueString
-//        = model->data(model->index(source_row,
-//                                   1 + i * compareModelCount)).toString();
-//    bool convOk = false;
-//    auto firstValue = QString::number(firstValueString.toDouble(&convOk));
-//    if (!convOk) {
-//      firstValue = firstValueString;
-//    }
-//    for (int j = 1; j < compareModelCount; ++j) {
-//      auto otherValueString
-//          = model->data(model->index(source_row,
-//                                     1 + i * compareModelCount + j)).toString();
-//      auto otherValue = QString::number(otherValueString.toDouble(&convOk));
-//      if (!convOk) {
-//        otherValue = otherValueString;
-//      }
-//      if (firstValue != otherValue) {
-//        return true;
-//      }
-    }
-  }
-  return false;
+  return compareModelData->m_differentRows.testBit(source_row);
 }
 
 bool CompareModel::filterAcceptsColumn
@@ -112,6 +65,8 @@ CompareModelData::CompareModelData
     }
   }
 
+  updateModelColumns();
+
   for (auto model : m_tableModelList) {
     connect(model, &QAbstractTableModel::modelAboutToBeReset,
             this, &CompareModelData::clear);
@@ -153,6 +108,7 @@ void CompareModelData::clear()
 //  }
   m_pointList.clear();
   m_pointByKks.clear();
+  m_differentRows.clear();
   endResetModel();
 }
 
@@ -171,12 +127,7 @@ QVariant CompareModelData::data(const QModelIndex &index, int role) const
       if (modelRow == -1) {
         return QVariant();
       }
-      QStringList modelHeaders;
-      for (int i = 0; i < model->columnCount(); ++i) {
-        modelHeaders += model->headerData(i, Qt::Horizontal).toString();
-      }
-      auto modelColumn
-          = modelHeaders.indexOf(m_parameterList[parameterNumber][modelNumber]);
+      auto modelColumn = m_modelColumns[parameterNumber][modelNumber];
       auto modelIndex = model->index(modelRow, modelColumn);
       return model->data(modelIndex);
     }
@@ -188,6 +139,8 @@ void CompareModelData::runComparition()
 {
   if (CompareParameterChooser(this).exec() == QDialog::Accepted) {
     beginResetModel();
+    // The headers of the models depend on the loaded files
+    updateModelColumns();
     for(int modelNumber = 0;
         modelNumber < m_tableModelList.size();
         ++modelNumber) {
@@ -195,10 +148,11 @@ void CompareModelData::runComparition()
       auto rowCount = model->rowCount();
       for (int row = 0; row < rowCount; ++row) {
         auto kksIndex = model->index(row, 0);
-        auto kks = model->data(kksIndex).toString();
+        auto kksString = model->data(kksIndex).toString();
+        auto kks = StringPool::instance().intern(kksString);
         if (!m_pointByKks.contains(kks)) {
           auto data = new QPair<QString, QVector<int>>
-              (kks, QVector<int>(m_tableModelList.size(), -1));
+              (kksString, QVector<int>(m_tableModelList.size(), -1));
           m_pointList.append(data);
           m_pointList.last()->second[modelNumber] = row;
           m_pointByKks.insert(kks, m_pointList.last());
@@ -208,7 +162,7 @@ void CompareModelData::runComparition()
       }
     }
     for (int i = 0; i < m_pointList.size();) {
-      auto kks = m_pointList[i]->first;
+      auto kks = StringPool::instance().find(m_pointList[i]->first);
       auto rows = m_pointList[i]->second;
       int existingRowsCount = 0;
       for (auto row : rows) {
@@ -224,10 +178,73 @@ void CompareModelData::runComparition()
       m_pointByKks.remove(kks);
       skipRemove:;
     }
+    updateDifferentRows();
     endResetModel();
   }
 }
 
+void CompareModelData::updateModelColumns()
+{
+  m_modelColumns.clear();
+  for (const auto& parameters : m_parameterList) {
+    m_modelColumns.append(QVector<int>());
+    for (int modelNumber = 0;
+         modelNumber < m_tableModelList.size();
+         ++modelNumber) {
+      auto model = m_tableModelList[modelNumber];
+      QStringList modelHeaders;
+      for (int i = 0; i < model->columnCount(); ++i) {
+        modelHeaders += model->headerData(i, Qt::Horizontal).toString();
+      }
+      m_modelColumns.last().append(
+            modelHeaders.indexOf(parameters[modelNumber]));
+    }
+  }
+}
+
+void CompareModelData::updateComparedParameters()
+{
+  // The reset makes the proxy filter the rows again
+  beginResetModel();
+  updateModelColumns();
+  updateDifferentRows();
+  endResetModel();
+}
+
+void CompareModelData::updateDifferentRows()
+{
+  auto compareModelCount = m_tableModelList.size();
+  m_differentRows = QBitArray(m_pointList.size());
+  for (int row = 0; row < m_pointList.size(); ++row) {
+    for (int i = 0;
+         i < m_parameterList.size() && !m_differentRows.testBit(row);
+         ++i) {
+      auto value = QVariant();
+      for (int j = 0; j < compareModelCount; ++j) {
+        if (m_tableModelList[j]->rowCount() != 0) {
+          auto stringValue
+              = data(index(row, 1 + i * compareModelCount + j)).toString();
+          bool convOk = false;
+          auto doubleValue = QString::number(stringValue.toDouble(&convOk));
+          if (value.isValid()) {
+            if ((convOk && value != doubleValue)
+                || (!convOk && value != stringValue)) {
+              m_differentRows.setBit(row);
+              break;
+            }
+          } else {
+            if (convOk) {
+              value = doubleValue;
+            } else {
+              value = stringValue;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 CompareParameterChooser::CompareParameterChooser(CompareModelData *compareModel)
   : QDialog(), m_compareModel(compareModel)
 {
@@ -321,6 +338,7 @@ void CompareParameterChooser::addComboBoxesWidget(QVBoxLayout *scrollLayout)
         m_compareModel
         ->m_parameterList[parameterListIndex][parameterIndex] =
             comboBox->itemText(index);
+        m_compareModel->updateComparedParameters();
       });
     }
 
@@ -337,6 +355,7 @@ void CompareParameterChooser::addComboBoxesWidget(QVBoxLayout *scrollLayout)
       delete comboBoxesWidget;
       m_comboBoxVectorList.removeAt(index);
       m_compareModel->m_parameterList.removeAt(index);
+      m_compareModel->updateComparedParameters();
     });
 
     scrollLayout->addWidget(comboBoxesWidget);
@@ -353,6 +372,7 @@ void CompareParameterChooser::addComboBoxes(QVBoxLayout* scrollLayout) {
     parametersList.append(comboBox->currentText());
   }
   m_compareModel->m_parameterList.append(parametersList);
+  m_compareModel->updateComparedParameters();
 }
 
 void CompareParameterChooser::addComboBoxes(QVBoxLayout *scrollLayout,
@@ -2,12 +2,16 @@
 
 #include <QSortFilterProxyModel>
 
+#include <QBitArray>
+
 #include <QComboBox>
 #include <QVBoxLayout>
 #include <QDialog>
 #include <QScrollArea>
 #include <QScrollBar>
 
+#include "stringpool.h"
+
 class CompareModelData;
 
 class CompareModel : public QSortFilterProxyModel
@@ -86,7 +90,19 @@ private:
   QList<QList<QString>> m_parameterList;
   QList<QPair<QString, QVector<int>>*> m_pointList;
   //                   kks       rows
-  QMap<QString, QPair<QString, QVector<int>>*> m_pointByKks;
+  QHash<StringPool::Id, QPair<QString, QVector<int>>*> m_pointByKks;
+  // Rows with different values of a compared parameter, numbers are
+  // compared by value. Filled by runComparition and again whenever the
+  // compared parameters are edited.
+  QBitArray m_differentRows;
+  // Columns of the compared parameters in every model, by parameter and
+  // model number
+  QVector<QVector<int>> m_modelColumns;
+
+  void updateModelColumns();
+  void updateDifferentRows();
+  // Called whenever the compared parameters are edited
+  void updateComparedParameters();
 
   QList<QAbstractTableModel*> m_tableModelList;
 
@@ -0,0 +1,155 @@
+#include "dbidparser.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "mappedfile.h"
+
+DbidParser::DbidParser(const char* data, qint64 size)
+    : data_(data), size_(size) {}
+
+QString DbidParser::Token::toString(const MappedFile& file) const {
+  return file.decode(data, size);
+}
+
+void DbidParser::parse(Handler& handler,
+                       const std::function<void (int percent)>& progress) {
+  progress_ = progress;
+  last_percent_ = -1;
+
+  auto header_end = static_cast<const char*>(
+        std::memchr(data_, '\n', static_cast<size_t>(size_)));
+  pos_ = header_end ? header_end - data_ + 1 : size_;
+
+  while (readEntityType() == EntityType::object) {
+    readObject(handler);
+  }
+}
+
+DbidParser::EntityType DbidParser::readEntityType() {
+  skipSpaces();
+  if (pos_ >= size_) {
+    return EntityType::undefined;
+  }
+  auto ch = data_[pos_++];
+  skipSpaces();
+  if (ch == '(') {
+    return EntityType::object;
+  } else if (ch == '[') {
+    return EntityType::array;
+  } else {
+    return EntityType::undefined;
+  }
+}
+
+void DbidParser::readObject(Handler& handler) {
+  auto type = readParameter().second;
+  auto name = readParameter().second;
+
+  handler.beginObject(type, name);
+
+  while (true) {
+    if (pos_ >= size_) {
+      qFatal("Unexpected end of DBID. Expected ')'");
+    }
+    if (data_[pos_] == ')') {
+      ++pos_;
+      skipSpaces();
+      break;
+    }
+    auto operation = readEntityType();
+    if (operation == EntityType::array) {
+      while (true) {
+        if (pos_ >= size_) {
+          qFatal("Unexpected end of DBID. Expected ']'");
+        }
+        if (data_[pos_] == ']') {
+          ++pos_;
+          skipSpaces();
+          break;
+        }
+        auto parameter = readParameter();
+        handler.parameter(parameter.first, parameter.second);
+      }
+    } else if (operation == EntityType::object) {
+      readObject(handler);
+    } else {
+      qFatal("Unexpected character. Expected '(' or '['");
+    }
+  }
+
+  handler.endObject();
+
+  reportProgress();
+}
+
+QPair<DbidParser::Token, DbidParser::Token> DbidParser::readParameter() {
+  auto parameter_name = readKeyword();
+  if (parameter_name.size == 0) {
+    qFatal("Parameter name is empty");
+  }
+  skipSpaces();
+  if (pos_ >= size_ || data_[pos_++] != '=') {
+    qFatal("Unexpected character. Expected '='");
+  }
+  skipSpaces();
+  auto parameter_value = readValue();
+  skipSpaces();
+  return {parameter_name, parameter_value};
+}
+
+DbidParser::Token DbidParser::readKeyword() {
+  auto begin = pos_;
+  while (pos_ < size_) {
+    auto ch = static_cast<unsigned char>(data_[pos_]);
+    // Non-ASCII bytes are letters of the local 8-bit encoding
+    if ((ch >= 'a' && ch <= 'z')
+        || (ch >= 'A' && ch <= 'Z')
+        || (ch >= '0' && ch <= '9')
+        || ch == '.'
+        || ch == '_'
+        || ch == '-'
+        || ch >= 0x80) {
+      ++pos_;
+    } else {
+      break;
+    }
+  }
+  return {data_ + begin, static_cast<int>(pos_ - begin)};
+}
+
+DbidParser::Token DbidParser::readValue() {
+  if (pos_ >= size_ || data_[pos_++] != '"') {
+    qFatal("Error. Expected quote");
+  }
+  auto end = static_cast<const char*>(
+        std::memchr(data_ + pos_, '"', static_cast<size_t>(size_ - pos_)));
+  if (end == nullptr) {
+    qFatal("Error. Quote is not closed");
+  }
+  Token value = {data_ + pos_, static_cast<int>(end - (data_ + pos_))};
+  pos_ = end - data_ + 1;
+  return value;
+}
+
+void DbidParser::skipSpaces() {
+  while (pos_ < size_) {
+    auto ch = data_[pos_];
+    if (ch == ' ' || ch == '\n' || ch == '\r'
+        || ch == '\t' || ch == '\v' || ch == '\f') {
+      ++pos_;
+    } else {
+      break;
+    }
+  }
+}
+
+void DbidParser::reportProgress() {
+  if (progress_) {
+    auto percent = static_cast<int>(std::lround(100.0 * pos_ / size_));
+    if (percent != last_percent_) {
+      last_percent_ = percent;
+      progress_(percent);
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+
+#include <QPair>
+#include <QString>
+
+class MappedFile;
+
+class DbidParser {
+public:
+  DbidParser(const char* data, qint64 size);
+
+  // Token is a view into the parsed buffer, nothing is copied until
+  // toString() is called with the file the buffer belongs to.
+  struct Token {
+    const char* data = nullptr;
+    int size = 0;
+
+    QString toString(const MappedFile& file) const;
+  };
+
+  class Handler {
+  public:
+    virtual ~Handler() = default;
+    virtual void beginObject(const Token& type, const Token& name) = 0;
+    virtual void parameter(const Token& name, const Token& value) = 0;
+    virtual void endObject() = 0;
+  };
+
+  void parse(Handler& handler,
+             const std::function<void (int percent)>& progress = {});
+
+private:
+  enum class EntityType {
+    object, array, undefined
+  };
+
+  EntityType readEntityType();
+  void readObject(Handler& handler);
+  QPair<Token, Token> readParameter();
+  Token readKeyword();
+  Token readValue();
+  void skipSpaces();
+  void reportProgress();
+
+  const char* data_;
+  qint64 size_;
+  qint64 pos_ = 0;
+
+  std::function<void (int percent)> progress_;
+  int last_percent_ = -1;
+};
@@ -0,0 +1,67 @@
+#include "dbidpatch.h"
+
+bool DbidPatch::isEmpty() const {
+  return edits_.isEmpty() && appended_parameters_.isEmpty();
+}
+
+void DbidPatch::clear() {
+  edits_.clear();
+  appended_parameters_.clear();
+}
+
+void DbidPatch::setParameter(Node node, const QString& parameter) {
+  auto& edit = edits_[node];
+  edit.parameter = parameter;
+  edit.parameter_set = true;
+}
+
+void DbidPatch::setValue(Node node, const QString& value) {
+  auto& edit = edits_[node];
+  edit.value = value;
+  edit.value_set = true;
+}
+
+void DbidPatch::appendParameter(Node object,
+                                const QString& name,
+                                const QString& value) {
+  appended_parameters_[object].append({name, value});
+}
+
+const QString& DbidPatch::parameter(const DbidTree& tree, Node node) const {
+  auto it = edits_.constFind(node);
+  if (it != edits_.constEnd() && it->parameter_set) {
+    return it->parameter;
+  }
+  return tree.parameter(node);
+}
+
+const QString& DbidPatch::value(const DbidTree& tree, Node node) const {
+  auto it = edits_.constFind(node);
+  if (it != edits_.constEnd() && it->value_set) {
+    return it->value;
+  }
+  return tree.value(node);
+}
+
+const QVector<DbidPatch::Parameter>& DbidPatch::appendedParameters(
+    Node object) const {
+  static const QVector<Parameter> no_parameters;
+  auto it = appended_parameters_.constFind(object);
+  return it != appended_parameters_.constEnd() ? *it : no_parameters;
+}
+
+void DbidPatch::merge(const DbidPatch& other) {
+  for (auto it = other.edits_.constBegin();
+       it != other.edits_.constEnd(); ++it) {
+    if (it->parameter_set) {
+      setParameter(it.key(), it->parameter);
+    }
+    if (it->value_set) {
+      setValue(it.key(), it->value);
+    }
+  }
+  for (auto it = other.appended_parameters_.constBegin();
+       it != other.appended_parameters_.constEnd(); ++it) {
+    appended_parameters_[it.key()] += *it;
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "dbidtree.h"
+
+// Changes layered over a shared DbidTree: new names and values of its
+// nodes and parameters appended to its objects. The tree is never
+// modified, a patch only holds what has changed, so edits and automatic
+// corrections cost memory in proportion to their size.
+class DbidPatch {
+public:
+  using Node = DbidTree::Node;
+
+  struct Parameter {
+    QString name;
+    QString value;
+  };
+
+  bool isEmpty() const;
+  void clear();
+
+  void setParameter(Node node, const QString& parameter);
+  void setValue(Node node, const QString& value);
+  // The parameter is written after the other parameters of the object
+  void appendParameter(Node object, const QString& name, const QString& value);
+
+  // Name and value of the node with the patch applied
+  const QString& parameter(const DbidTree& tree, Node node) const;
+  const QString& value(const DbidTree& tree, Node node) const;
+  const QVector<Parameter>& appendedParameters(Node object) const;
+
+  // Applies the changes of the other patch over the changes of this one
+  void merge(const DbidPatch& other);
+
+private:
+  struct Edit {
+    QString parameter;
+    QString value;
+    bool parameter_set = false;
+    bool value_set = false;
+  };
+
+  QHash<Node, Edit> edits_;
+  QHash<Node, QVector<Parameter>> appended_parameters_;
+};
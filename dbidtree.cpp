@@ -0,0 +1,246 @@
+#include "dbidtree.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QHash>
+
+DbidTree::DbidTree() {
+  clear();
+}
+
+int DbidTree::size() const {
+  return nodes_.size();
+}
+
+int DbidTree::childCount(Node node) const {
+  return nodes_[node].child_count;
+}
+
+MappedFile::Encoding DbidTree::encoding() const {
+  return encoding_;
+}
+
+DbidTree::Node DbidTree::child(Node node, int row) const {
+  if (row < 0 || row >= nodes_[node].child_count) {
+    return null;
+  }
+  return children_[nodes_[node].first_child + row];
+}
+
+DbidTree::Node DbidTree::parent(Node node) const {
+  return nodes_[node].parent;
+}
+
+int DbidTree::row(Node node) const {
+  return nodes_[node].row;
+}
+
+const QString& DbidTree::parameter(Node node) const {
+  return strings_[nodes_[node].parameter];
+}
+
+const QString& DbidTree::value(Node node) const {
+  return strings_[nodes_[node].value];
+}
+
+DbidTree::Node DbidTree::findChild(Node node, const QString& parameter) const {
+  auto range = equalRange(children_by_parameter_,
+                          &NodeData::parameter,
+                          node,
+                          find(parameter));
+  return range.first != range.second ? *range.first : null;
+}
+
+QVector<DbidTree::Node> DbidTree::childrenOfType(Node node,
+                                                 const QString& type) const {
+  auto range = equalRange(children_by_value_,
+                          &NodeData::value,
+                          node,
+                          find(type));
+  QVector<Node> children;
+  for (auto child = range.first; child != range.second; ++child) {
+    children.append(*child);
+  }
+  return children;
+}
+
+QVector<DbidTree::Node> DbidTree::select(Node node,
+                                         const QString& path) const {
+  QVector<Node> nodes = {node};
+  for (const auto& type : path.split('/')) {
+    auto id = find(type);
+    QVector<Node> children;
+    for (auto parent : nodes) {
+      auto range = equalRange(children_by_value_, &NodeData::value, parent, id);
+      for (auto child = range.first; child != range.second; ++child) {
+        children.append(*child);
+      }
+    }
+    nodes.swap(children);
+  }
+  return nodes;
+}
+
+void DbidTree::clear() {
+  nodes_ = {};
+  children_ = {};
+  children_by_parameter_ = {};
+  children_by_value_ = {};
+  strings_ = {};
+  string_bytes_ = {};
+  string_spans_ = {};
+  string_hashes_ = {};
+  buckets_ = {};
+  encoding_ = MappedFile::Encoding::LOCAL_8BIT;
+  rehash(1024);
+  auto empty = intern("", 0);
+  nodes_.append({empty, empty, null, 0, 0, 0});
+}
+
+DbidTree::Node DbidTree::addNode(Node parent, int parameter, int value) {
+  nodes_.append({parameter, value, parent, 0, 0, 0});
+  ++nodes_[parent].child_count;
+  return nodes_.size() - 1;
+}
+
+void DbidTree::buildChildRanges() {
+  int offset = 0;
+  for (auto& node : nodes_) {
+    node.first_child = offset;
+    offset += node.child_count;
+    node.child_count = 0;
+  }
+  children_.resize(offset);
+  // Nodes were appended in document order, so filling the ranges in node
+  // order keeps the children in document order as well
+  for (Node node = root + 1; node < nodes_.size(); ++node) {
+    auto& parent = nodes_[nodes_[node].parent];
+    nodes_[node].row = parent.child_count;
+    children_[parent.first_child + parent.child_count++] = node;
+  }
+  // The same ranges sorted by the string ids, equal ids keep the document
+  // order
+  auto sortRanges = [this](QVector<Node>& index, int NodeData::* key) {
+    index = children_;
+    for (const auto& node : nodes_) {
+      auto first = index.begin() + node.first_child;
+      std::stable_sort(first, first + node.child_count,
+                       [this, key](Node left, Node right) {
+        return nodes_[left].*key < nodes_[right].*key;
+      });
+    }
+  };
+  sortRanges(children_by_parameter_, &NodeData::parameter);
+  sortRanges(children_by_value_, &NodeData::value);
+  nodes_.squeeze();
+  strings_.squeeze();
+}
+
+QPair<const DbidTree::Node*, const DbidTree::Node*> DbidTree::equalRange(
+    const QVector<Node>& index,
+    int NodeData::* key,
+    Node node,
+    int id) const {
+  auto first = index.constData() + nodes_[node].first_child;
+  auto last = first + nodes_[node].child_count;
+  if (id == -1) {
+    return {last, last};
+  }
+  first = std::lower_bound(first, last, id, [this, key](Node child, int id) {
+    return nodes_[child].*key < id;
+  });
+  last = std::upper_bound(first, last, id, [this, key](int id, Node child) {
+    return id < nodes_[child].*key;
+  });
+  return {first, last};
+}
+
+int DbidTree::intern(const char* data, int size) {
+  auto hash = qHashBits(data, static_cast<size_t>(size));
+  auto mask = buckets_.size() - 1;
+  auto bucket = static_cast<int>(hash) & mask;
+  while (buckets_[bucket] != -1) {
+    auto id = buckets_[bucket];
+    const auto& span = string_spans_[id];
+    if (string_hashes_[id] == hash
+        && span.second == size
+        && std::memcmp(string_bytes_.constData() + span.first,
+                       data,
+                       static_cast<size_t>(size)) == 0) {
+      return id;
+    }
+    bucket = (bucket + 1) & mask;
+  }
+
+  auto id = strings_.size();
+  string_spans_.append({string_bytes_.size(), size});
+  string_bytes_.append(data, size);
+  string_hashes_.append(hash);
+  strings_.append(MappedFile::decode(encoding_, data, size));
+  buckets_[bucket] = id;
+  if (strings_.size() * 2 > buckets_.size()) {
+    rehash(buckets_.size() * 2);
+  }
+  return id;
+}
+
+int DbidTree::find(const QString& string) const {
+  // Strings are hashed by the bytes they were read from
+  auto bytes = MappedFile::encode(encoding_, string);
+  auto hash = qHashBits(bytes.constData(), static_cast<size_t>(bytes.size()));
+  auto mask = buckets_.size() - 1;
+  auto bucket = static_cast<int>(hash) & mask;
+  while (buckets_[bucket] != -1) {
+    auto id = buckets_[bucket];
+    if (string_hashes_[id] == hash && strings_[id] == string) {
+      return id;
+    }
+    bucket = (bucket + 1) & mask;
+  }
+  return -1;
+}
+
+void DbidTree::rehash(int bucket_count) {
+  buckets_.fill(-1, bucket_count);
+  auto mask = bucket_count - 1;
+  for (int id = 0; id < string_hashes_.size(); ++id) {
+    auto bucket = static_cast<int>(string_hashes_[id]) & mask;
+    while (buckets_[bucket] != -1) {
+      bucket = (bucket + 1) & mask;
+    }
+    buckets_[bucket] = id;
+  }
+}
+
+DbidTree::Builder::Builder(DbidTree& tree, const MappedFile& file)
+    : tree_(tree) {
+  tree_.encoding_ = file.encoding();
+}
+
+void DbidTree::Builder::beginObject(const DbidParser::Token& type,
+                                    const DbidParser::Token& name) {
+  auto node = tree_.addNode(current_,
+                            tree_.intern(name.data, name.size),
+                            tree_.intern(type.data, type.size));
+  parents_.append(current_);
+  current_ = node;
+}
+
+void DbidTree::Builder::parameter(const DbidParser::Token& name,
+                                  const DbidParser::Token& value) {
+  tree_.addNode(current_,
+                tree_.intern(name.data, name.size),
+                tree_.intern(value.data, value.size));
+}
+
+void DbidTree::Builder::endObject() {
+  current_ = parents_.takeLast();
+}
+
+void DbidTree::Builder::finish() {
+  tree_.buildChildRanges();
+  // The hashes and buckets stay for the lookups by string
+  tree_.string_bytes_ = {};
+  tree_.string_spans_ = {};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QByteArray>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include "dbidparser.h"
+#include "mappedfile.h"
+
+// Flat DBID tree. Nodes live in one contiguous array, children of a node
+// are a contiguous range of an index array and every parameter name and
+// value is interned, so the whole tree is released by clear(). The children
+// of every node are also indexed by parameter name and by value, which is
+// the type of an object, so lookups by name or type do not scan the
+// children.
+class DbidTree {
+public:
+  using Node = int;
+  static constexpr Node root = 0;
+  static constexpr Node null = -1;
+
+  DbidTree();
+
+  int size() const;
+  int childCount(Node node) const;
+  Node child(Node node, int row) const;
+  Node parent(Node node) const;
+  int row(Node node) const;
+  const QString& parameter(Node node) const;
+  const QString& value(Node node) const;
+  // Encoding of the file the tree has been read from
+  MappedFile::Encoding encoding() const;
+
+  // First child with the parameter name, null if there is none
+  Node findChild(Node node, const QString& parameter) const;
+  // Children whose value is the type, in document order
+  QVector<Node> childrenOfType(Node node, const QString& type) const;
+  // Nodes reached from the node by a path of types separated by '/', e.g.
+  // select(root, "System/Network/Unit/Drop")
+  QVector<Node> select(Node node, const QString& path) const;
+
+  void clear();
+
+  // The strings are decoded with the encoding of the file
+  class Builder : public DbidParser::Handler {
+  public:
+    Builder(DbidTree& tree, const MappedFile& file);
+
+    void beginObject(const DbidParser::Token& type,
+                     const DbidParser::Token& name) override;
+    void parameter(const DbidParser::Token& name,
+                   const DbidParser::Token& value) override;
+    void endObject() override;
+
+    void finish();
+
+  private:
+    DbidTree& tree_;
+    Node current_ = root;
+    QVector<Node> parents_;
+  };
+
+private:
+  struct NodeData {
+    int parameter;
+    int value;
+    Node parent;
+    int first_child;
+    int child_count;
+    int row;
+  };
+
+  Node addNode(Node parent, int parameter, int value);
+  void buildChildRanges();
+  // Children of the node whose string of the key is the string id
+  QPair<const Node*, const Node*> equalRange(const QVector<Node>& index,
+                                             int NodeData::* key,
+                                             Node node,
+                                             int id) const;
+
+  int intern(const char* data, int size);
+  // -1 if the tree has no such string
+  int find(const QString& string) const;
+  void rehash(int bucket_count);
+
+  QVector<NodeData> nodes_;
+  QVector<Node> children_;
+  QVector<Node> children_by_parameter_;
+  QVector<Node> children_by_value_;
+
+  MappedFile::Encoding encoding_ = MappedFile::Encoding::LOCAL_8BIT;
+  QVector<QString> strings_;
+  QByteArray string_bytes_;
+  QVector<QPair<int, int>> string_spans_;
+  QVector<uint> string_hashes_;
+  QVector<int> buckets_;
+};
@@ -0,0 +1,558 @@
+#include "filterrule.h"
+
+#include <QJsonArray>
+#include <QRegularExpression>
+
+namespace {
+
+  enum class File {
+    DBID, SRC, XML, OPHXML
+  };
+
+  const QHash<QString, FilterRule::Operation> operation_names = {
+    {"empty", FilterRule::Operation::EMPTY},
+    {"not_empty", FilterRule::Operation::NOT_EMPTY},
+    {"==", FilterRule::Operation::EQUAL},
+    {"!=", FilterRule::Operation::NOT_EQUAL},
+    {"<", FilterRule::Operation::LESS},
+    {"<=", FilterRule::Operation::LESS_EQUAL},
+    {">", FilterRule::Operation::GREATER},
+    {">=", FilterRule::Operation::GREATER_EQUAL},
+    {"matches", FilterRule::Operation::MATCHES},
+    {"not_matches", FilterRule::Operation::NOT_MATCHES},
+    {"in", FilterRule::Operation::IN_FILE},
+    {"not_in", FilterRule::Operation::NOT_IN_FILE}
+  };
+
+  const QHash<QString, File> file_names = {
+    {"DBID", File::DBID},
+    {"SRC", File::SRC},
+    {"XML", File::XML},
+    {"OPHXML", File::OPHXML}
+  };
+
+  const QString link_prefix = "link.";
+
+  bool parameterFromJson(const QJsonValue& json,
+                         PointInfo::Parameter& parameter) {
+    if (!json.isString()) {
+      return false;
+    }
+    parameter = PointInfo::parameterFromString(json.toString());
+    return static_cast<int>(parameter) >= 0;
+  }
+
+  bool parametersFromJson(const QJsonValue& json,
+                          QVector<PointInfo::Parameter>& parameters) {
+    for (const auto& value : json.toArray()) {
+      PointInfo::Parameter parameter;
+      if (!parameterFromJson(value, parameter)) {
+        return false;
+      }
+      parameters.append(parameter);
+    }
+    return true;
+  }
+
+  bool operandFromJson(const QString& json, FilterRule::Operand& operand) {
+    operand.linked = json.startsWith(link_prefix);
+    return parameterFromJson(
+          operand.linked ? json.mid(link_prefix.size()) : json,
+          operand.parameter);
+  }
+
+  bool conditionFromJson(const QJsonValue& json,
+                         FilterRule::Condition& condition) {
+    using Operation = FilterRule::Operation;
+    auto parts = json.toArray();
+    if (parts.size() == 2 && parts[0].toString() == "any") {
+      condition.operation = Operation::ANY;
+      for (const auto& any_json : parts[1].toArray()) {
+        FilterRule::Condition any;
+        if (!conditionFromJson(any_json, any)) {
+          return false;
+        }
+        condition.any_of.append(any);
+      }
+      return !condition.any_of.isEmpty();
+    }
+    if (parts.size() < 2 || parts.size() > 3
+        || !operation_names.contains(parts[1].toString())) {
+      return false;
+    }
+    condition.operation = operation_names[parts[1].toString()];
+    if (!operandFromJson(parts[0].toString(), condition.operand)) {
+      return false;
+    }
+    auto unary = condition.operation == Operation::EMPTY
+        || condition.operation == Operation::NOT_EMPTY;
+    if (unary != (parts.size() == 2)) {
+      return false;
+    }
+    if (!unary) {
+      auto value = parts[2].toVariant().toString();
+      if (value.startsWith('@')) {
+        condition.compare_parameter = true;
+        if (!operandFromJson(value.mid(1), condition.other)) {
+          return false;
+        }
+      } else {
+        condition.value = value;
+      }
+      if ((condition.operation == Operation::IN_FILE
+           || condition.operation == Operation::NOT_IN_FILE)
+          && (condition.compare_parameter || !file_names.contains(value))) {
+        return false;
+      }
+      if ((condition.operation == Operation::MATCHES
+           || condition.operation == Operation::NOT_MATCHES)
+          && condition.compare_parameter) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool isEmptyValue(const PointStore& store, StringPool::Id id) {
+    return id == PointStore::null_value || store.string(id).isEmpty();
+  }
+
+  // A missing parameter reads as a null string, which is equal to an empty
+  // one
+  bool isEqualValue(const PointStore& store,
+                    StringPool::Id first,
+                    StringPool::Id second) {
+    return first == second
+        || (isEmptyValue(store, first) && isEmptyValue(store, second));
+  }
+
+  bool isInFile(const PointStore& store, int row, int file) {
+    switch (static_cast<File>(file)) {
+      case File::DBID:
+        return store.isInDBID(row);
+      case File::SRC:
+        return store.isInSRC(row);
+      case File::XML:
+        return store.isInXML(row);
+      case File::OPHXML:
+        return store.isInOPHXML(row);
+    }
+    return false;
+  }
+
+}
+
+FilterRule::Operand::Operand(PointInfo::Parameter parameter, bool linked)
+    : parameter(parameter), linked(linked) {}
+
+FilterRule::Condition::Condition(const Operand& operand,
+                                 Operation operation,
+                                 const QString& value)
+    : operand(operand), operation(operation), value(value) {}
+
+FilterRule::Condition::Condition(const Operand& operand,
+                                 Operation operation,
+                                 const Operand& other)
+    : operand(operand),
+      operation(operation),
+      compare_parameter(true),
+      other(other) {}
+
+FilterRule::Operand FilterRule::linked(PointInfo::Parameter parameter) {
+  return Operand(parameter, true);
+}
+
+FilterRule::Condition FilterRule::any(const QVector<Condition>& conditions) {
+  Condition condition;
+  condition.operation = Operation::ANY;
+  condition.any_of = conditions;
+  return condition;
+}
+
+bool FilterRule::fromJson(const QJsonObject& json, FilterRule& rule) {
+  rule.group = json["group"].toString();
+  rule.message = json["message"].toString();
+  if (!parametersFromJson(json["errors"], rule.errors)
+      || !parametersFromJson(json["warnings"], rule.warnings)) {
+    return false;
+  }
+  for (const auto& suffix_json : json["link"].toArray()) {
+    auto suffixes = suffix_json.toArray();
+    if (suffixes.size() != 2 || !suffixes[0].isString()
+        || !suffixes[1].isString() || suffixes[0].toString().isEmpty()) {
+      return false;
+    }
+    rule.link.append({suffixes[0].toString(), suffixes[1].toString()});
+  }
+  auto conditions = json["conditions"].toArray();
+  if (conditions.isEmpty()) {
+    return false;
+  }
+  for (const auto& condition_json : conditions) {
+    Condition condition;
+    if (!conditionFromJson(condition_json, condition)) {
+      return false;
+    }
+    rule.conditions.append(condition);
+  }
+  return true;
+}
+
+FilterRulePlan FilterRulePlan::compile(const QVector<FilterRule>& rules) {
+  // Rules of a group are moved next to its first rule, the order of the
+  // groups and of the rules in a group is kept
+  QVector<QVector<const FilterRule*>> ordered_groups;
+  QHash<QString, int> group_index;
+  for (const auto& rule : rules) {
+    if (rule.group.isEmpty()) {
+      ordered_groups.append({&rule});
+    } else if (group_index.contains(rule.group)) {
+      ordered_groups[group_index[rule.group]].append(&rule);
+    } else {
+      group_index.insert(rule.group, ordered_groups.size());
+      ordered_groups.append({&rule});
+    }
+  }
+
+  FilterRulePlan plan;
+  for (const auto& group : ordered_groups) {
+    auto group_end = plan.rules_.size() + group.size();
+    for (auto rule : group) {
+      CompiledRule compiled;
+      compiled.mode = rule->mode;
+      compiled.group_end = group_end;
+
+      // Rules with the same suffixes share the linked row
+      compiled.link = -1;
+      if (!rule->link.isEmpty()) {
+        compiled.link = plan.links_.indexOf(rule->link);
+        if (compiled.link == -1) {
+          compiled.link = plan.links_.size();
+          plan.links_.append(rule->link);
+        }
+      }
+
+      compiled.first_instruction = plan.instructions_.size();
+      for (const auto& condition : rule->conditions) {
+        plan.compileCondition(condition);
+      }
+      compiled.instruction_count =
+          plan.instructions_.size() - compiled.first_instruction;
+
+      compiled.message = plan.compileText(rule->message);
+
+      compiled.first_color = plan.colors_.size();
+      for (auto parameter : rule->errors) {
+        plan.colors_.append({parameter, Severity::ERROR});
+      }
+      for (auto parameter : rule->warnings) {
+        plan.colors_.append({parameter, Severity::WARNING});
+      }
+      compiled.color_count = plan.colors_.size() - compiled.first_color;
+
+      plan.addDependencies(compiled);
+      plan.rules_.append(compiled);
+    }
+  }
+  return plan;
+}
+
+FilterRulePlan::Text FilterRulePlan::compileText(const QString& text) {
+  Text compiled;
+  compiled.first_part = text_parts_.size();
+  int pos = 0;
+  while (pos < text.size()) {
+    auto open = text.indexOf('{', pos);
+    auto close = open != -1 ? text.indexOf('}', open) : -1;
+    TextPart part{QString(), -1, false, false, 0};
+    if (close != -1) {
+      auto reference = text.mid(open + 1, close - open - 1);
+      part.linked = reference.startsWith(link_prefix);
+      if (part.linked) {
+        reference.remove(0, link_prefix.size());
+      }
+      auto sign = reference.indexOf(QRegularExpression("[+-]"));
+      if (sign != -1) {
+        part.offset = reference.mid(sign).toInt(&part.numeric);
+        reference.truncate(sign);
+      }
+      auto parameter = PointInfo::parameterFromString(reference);
+      if (static_cast<int>(parameter) >= 0 && (sign == -1 || part.numeric)) {
+        part.column = static_cast<int>(parameter);
+      }
+    }
+    if (part.column == -1) {
+      auto end = close != -1 ? close + 1 : text.size();
+      text_parts_.append({text.mid(pos, end - pos), -1, false, false, 0});
+      pos = end;
+      continue;
+    }
+    if (open > pos) {
+      text_parts_.append({text.mid(pos, open - pos), -1, false, false, 0});
+    }
+    text_parts_.append(part);
+    pos = close + 1;
+  }
+  compiled.part_count = text_parts_.size() - compiled.first_part;
+  return compiled;
+}
+
+void FilterRulePlan::compileCondition(const FilterRule::Condition& condition) {
+  using Operation = FilterRule::Operation;
+  auto index = instructions_.size();
+  Instruction instruction;
+  instruction.operation = condition.operation;
+  instruction.column = static_cast<int>(condition.operand.parameter);
+  instruction.linked = condition.operand.linked;
+  instruction.other_column = condition.compare_parameter
+      ? static_cast<int>(condition.other.parameter) : -1;
+  instruction.other_linked = condition.other.linked;
+  instruction.value_text = -1;
+  instruction.mask = -1;
+  // Comparisons with an empty value are checks for emptiness, a missing
+  // parameter has no id of an empty string
+  if (!condition.compare_parameter && condition.value.isEmpty()) {
+    if (instruction.operation == Operation::EQUAL) {
+      instruction.operation = Operation::EMPTY;
+    } else if (instruction.operation == Operation::NOT_EQUAL) {
+      instruction.operation = Operation::NOT_EMPTY;
+    }
+  }
+  if (instruction.operation == Operation::IN_FILE
+      || instruction.operation == Operation::NOT_IN_FILE) {
+    instruction.other_column =
+        static_cast<int>(file_names.value(condition.value));
+  } else if (instruction.operation == Operation::MATCHES
+             || instruction.operation == Operation::NOT_MATCHES) {
+    instruction.mask = masks_.size();
+    masks_.append(WildcardMask(condition.value));
+    mask_results_.append({});
+  } else if (!condition.compare_parameter) {
+    auto text = compileText(condition.value);
+    auto first = text_parts_.constBegin() + text.first_part;
+    if (std::any_of(first, first + text.part_count,
+                    [](const TextPart& part) { return part.column != -1; })) {
+      instruction.value_text = texts_.size();
+      texts_.append(text);
+    } else {
+      text_parts_.resize(text.first_part);
+    }
+  }
+  // The values are interned, so they get the same ids as the loaded ones
+  // regardless of when the rules are compiled
+  instruction.value_id = StringPool::instance().intern(condition.value);
+  instruction.number = condition.value.toFloat();
+  instructions_.append(instruction);
+  for (const auto& any : condition.any_of) {
+    compileCondition(any);
+  }
+  instructions_[index].size = instructions_.size() - index;
+}
+
+void FilterRulePlan::addDependencies(const CompiledRule& rule) {
+  auto& dependencies = dependencies_[rule.mode];
+  auto& columns = dependencies.columns;
+  columns.resize(PointInfo::point_parameters.size());
+  auto add_text = [this, &columns](const Text& text) {
+    auto part = text_parts_.constData() + text.first_part;
+    for (auto end = part + text.part_count; part != end; ++part) {
+      if (part->column != -1) {
+        columns.setBit(part->column);
+      }
+    }
+  };
+  auto instruction = instructions_.constData() + rule.first_instruction;
+  auto end = instruction + rule.instruction_count;
+  for (; instruction != end; ++instruction) {
+    if (instruction->operation == FilterRule::Operation::ANY) {
+      continue;
+    }
+    // The files of a point are read from APPEAR_IN_FILES
+    if (instruction->operation == FilterRule::Operation::IN_FILE
+        || instruction->operation == FilterRule::Operation::NOT_IN_FILE) {
+      columns.setBit(static_cast<int>(PointInfo::Parameter::APPEAR_IN_FILES));
+      continue;
+    }
+    columns.setBit(instruction->column);
+    if (instruction->other_column != -1) {
+      columns.setBit(instruction->other_column);
+    }
+    if (instruction->value_text != -1) {
+      add_text(texts_[instruction->value_text]);
+    }
+  }
+  add_text(rule.message);
+  if (rule.link != -1) {
+    columns.setBit(static_cast<int>(PointInfo::Parameter::KKS));
+    dependencies.other_rows = true;
+  }
+}
+
+bool FilterRulePlan::isEmpty() const {
+  return rules_.isEmpty();
+}
+
+FilterRulePlan::Dependencies FilterRulePlan::dependencies(int mode) const {
+  return dependencies_.value(mode);
+}
+
+void FilterRulePlan::prepare(const PointStore& store,
+                             const QVector<int>& rows) {
+  for (const auto& instruction : instructions_) {
+    if (instruction.mask == -1 || instruction.linked) {
+      continue;
+    }
+    const auto& mask = masks_[instruction.mask];
+    auto& results = mask_results_[instruction.mask];
+    results.clear();
+    auto column = static_cast<PointInfo::Parameter>(instruction.column);
+    for (auto row : rows) {
+      auto id = store.valueId(row, column);
+      if (!results.contains(id)) {
+        results.insert(id, mask.matches(store.string(id)));
+      }
+    }
+  }
+}
+
+int FilterRulePlan::linkedRow(const PointStore& store,
+                              const QHash<StringPool::Id, int>& rows_by_kks,
+                              int row,
+                              int link) const {
+  const auto& kks = store.value(row, PointInfo::Parameter::KKS);
+  for (const auto& suffix : links_[link]) {
+    if (kks.endsWith(suffix.first)) {
+      auto linked_kks = kks.left(kks.size() - suffix.first.size())
+          + suffix.second;
+      return rows_by_kks.value(StringPool::instance().find(linked_kks), row);
+    }
+  }
+  return row;
+}
+
+bool FilterRulePlan::matches(const PointStore& store,
+                             int row,
+                             int linked_row,
+                             const CompiledRule& rule) const {
+  auto instruction = instructions_.constData() + rule.first_instruction;
+  auto end = instruction + rule.instruction_count;
+  for (; instruction != end; instruction += instruction->size) {
+    if (!test(store, row, linked_row, instruction)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FilterRulePlan::test(const PointStore& store,
+                          int row,
+                          int linked_row,
+                          const Instruction* instruction) const {
+  using Operation = FilterRule::Operation;
+  auto operand_row = instruction->linked ? linked_row : row;
+  auto column = static_cast<PointInfo::Parameter>(instruction->column);
+  auto other_row = instruction->other_linked ? linked_row : row;
+  auto other_column =
+      static_cast<PointInfo::Parameter>(instruction->other_column);
+  auto is_equal = [&] {
+    if (instruction->value_text != -1) {
+      return store.value(operand_row, column)
+          == format(store, row, linked_row,
+                    texts_[instruction->value_text]);
+    }
+    return isEqualValue(store,
+                        store.valueId(operand_row, column),
+                        instruction->other_column != -1
+                        ? store.valueId(other_row, other_column)
+                        : instruction->value_id);
+  };
+  switch (instruction->operation) {
+    case Operation::EMPTY:
+      return isEmptyValue(store, store.valueId(operand_row, column));
+    case Operation::NOT_EMPTY:
+      return !isEmptyValue(store, store.valueId(operand_row, column));
+    case Operation::EQUAL:
+      return is_equal();
+    case Operation::NOT_EQUAL:
+      return !is_equal();
+    case Operation::LESS:
+    case Operation::LESS_EQUAL:
+    case Operation::GREATER:
+    case Operation::GREATER_EQUAL: {
+      double number = store.number(operand_row, column);
+      double other_number = instruction->number;
+      if (instruction->other_column != -1) {
+        other_number = store.number(other_row, other_column);
+      } else if (instruction->value_text != -1) {
+        other_number = format(store, row, linked_row,
+                              texts_[instruction->value_text]).toFloat();
+      }
+      if (instruction->operation == Operation::LESS) {
+        return number < other_number;
+      } else if (instruction->operation == Operation::LESS_EQUAL) {
+        return number <= other_number;
+      } else if (instruction->operation == Operation::GREATER) {
+        return number > other_number;
+      }
+      return number >= other_number;
+    }
+    case Operation::MATCHES:
+      return matchesMask(store, operand_row, *instruction);
+    case Operation::NOT_MATCHES:
+      return !matchesMask(store, operand_row, *instruction);
+    case Operation::IN_FILE:
+      return isInFile(store, operand_row, instruction->other_column);
+    case Operation::NOT_IN_FILE:
+      return !isInFile(store, operand_row, instruction->other_column);
+    case Operation::ANY: {
+      auto any = instruction + 1;
+      auto end = instruction + instruction->size;
+      for (; any != end; any += any->size) {
+        if (test(store, row, linked_row, any)) {
+          return true;
+        }
+      }
+      return false;
+    }
+  }
+  return false;
+}
+
+// Values missing from the prepared results, like the ones of the linked
+// points, are matched on the spot
+bool FilterRulePlan::matchesMask(const PointStore& store,
+                                 int row,
+                                 const Instruction& instruction) const {
+  auto id = store.valueId(
+        row, static_cast<PointInfo::Parameter>(instruction.column));
+  const auto& results = mask_results_[instruction.mask];
+  auto it = results.constFind(id);
+  if (it != results.constEnd()) {
+    return *it;
+  }
+  return masks_[instruction.mask].matches(store.string(id));
+}
+
+QString FilterRulePlan::format(const PointStore& store,
+                               int row,
+                               int linked_row,
+                               const Text& text) const {
+  QString result;
+  auto part = text_parts_.constData() + text.first_part;
+  auto end = part + text.part_count;
+  for (; part != end; ++part) {
+    if (part->column == -1) {
+      result += part->text;
+      continue;
+    }
+    const auto& value = store.value(
+          part->linked ? linked_row : row,
+          static_cast<PointInfo::Parameter>(part->column));
+    if (part->numeric) {
+      result += QString::number(value.toInt() + part->offset);
+    } else {
+      result += value;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+
+#include <QBitArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QPair>
+#include <QString>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include "point.h"
+#include "pointstore.h"
+#include "stringpool.h"
+#include "wildcardmask.h"
+
+// Declarative point check. The rule reports its message and colors when all
+// of its conditions hold. Rules with the same non-empty group are exclusive,
+// only the first matching rule of a group is reported, like an if - else if
+// chain.
+struct FilterRule {
+  enum class Operation {
+    EMPTY, NOT_EMPTY,
+    EQUAL, NOT_EQUAL,
+    LESS, LESS_EQUAL, GREATER, GREATER_EQUAL,
+    MATCHES, NOT_MATCHES,
+    IN_FILE, NOT_IN_FILE,
+    ANY
+  };
+
+  // Parameter of the checked point or of the point linked to it
+  struct Operand {
+    Operand(PointInfo::Parameter parameter = PointInfo::Parameter::KKS,
+            bool linked = false);
+
+    PointInfo::Parameter parameter;
+    bool linked;
+  };
+
+  // The operand is compared either with another operand or with a value.
+  // Numeric operations compare the values converted to numbers, MATCHES and
+  // NOT_MATCHES take a wildcard mask, IN_FILE and NOT_IN_FILE take "DBID",
+  // "SRC", "XML" or "OPHXML" as value. Any other value may refer to the
+  // operands like the message, {ANC_5+50} adds 50 to the number.
+  struct Condition {
+    Condition() = default;
+    Condition(const Operand& operand,
+              Operation operation,
+              const QString& value = QString());
+    Condition(const Operand& operand,
+              Operation operation,
+              const Operand& other);
+
+    Operand operand;
+    Operation operation;
+    bool compare_parameter = false;
+    Operand other;
+    QString value;
+    QVector<Condition> any_of;
+  };
+
+  static Operand linked(PointInfo::Parameter parameter);
+  // Holds when one of the conditions holds
+  static Condition any(const QVector<Condition>& conditions);
+
+  int mode = 0;
+  QString group;
+  QVector<Condition> conditions;
+  // {PARAMETER} is replaced with the value of the parameter and
+  // {link.PARAMETER} with the one of the linked point. A rule without a
+  // message only colors the parameters.
+  QString message;
+  QVector<PointInfo::Parameter> errors;
+  QVector<PointInfo::Parameter> warnings;
+  // The first suffix of the KKS found in the list is replaced to find the
+  // linked point. The point is linked to itself if no suffix matches or no
+  // point has the new KKS.
+  QVector<QPair<QString, QString>> link;
+
+  // Reads a rule in the settings.json format, except for the mode:
+  // {"conditions": [["SOE_POINT", "!=", "@SOE_ENABLED"], ["TYPE", "==", "DP"],
+  //                 ["any", [["ANC_1", "not_empty"], ["ANC_2", "not_empty"]]],
+  //                 ["link.IO_CHANNEL", "!=", "@ANC_7"]],
+  //  "link": [["_XQ02", "XQ01"], ["XQ02", "XQ01"]],
+  //  "message": "...", "errors": ["SOE_POINT"], "warnings": [], "group": ""}
+  // A value starting with '@' names an operand, "link." names a parameter of
+  // the linked point. Returns false if the rule is malformed.
+  static bool fromJson(const QJsonObject& json, FilterRule& rule);
+};
+
+// Rules compiled into flat arrays of instructions over the PointStore
+// columns. String comparisons compare StringPool ids, so a rule check does
+// no string lookups.
+class FilterRulePlan {
+public:
+  enum class Severity {
+    WARNING, ERROR
+  };
+
+  struct Color {
+    PointInfo::Parameter parameter;
+    Severity severity;
+  };
+
+  // Parameters read by the rules of a mode. The rules linking a point to
+  // another one depend on the other rows as well.
+  struct Dependencies {
+    QBitArray columns;
+    bool other_rows = false;
+  };
+
+  static FilterRulePlan compile(const QVector<FilterRule>& rules);
+
+  bool isEmpty() const;
+  Dependencies dependencies(int mode) const;
+
+  // Matches the masks once against every distinct value of the rows, which
+  // are checked afterwards. Must be called before the rows are evaluated,
+  // evaluate() itself is thread-safe.
+  void prepare(const PointStore& store, const QVector<int>& rows);
+
+  // Calls report(mode, message, colors) for every rule matched by the row
+  // whose mode is accepted by is_enabled(mode). The linked points are found
+  // by their interned KKS.
+  template<class IsEnabled, class Report>
+  void evaluate(const PointStore& store,
+                const QHash<StringPool::Id, int>& rows_by_kks,
+                int row,
+                IsEnabled&& is_enabled,
+                Report&& report) const {
+    QVarLengthArray<int, 4> linked_rows(links_.size());
+    std::fill(linked_rows.begin(), linked_rows.end(), -1);
+    for (int i = 0; i < rules_.size(); ++i) {
+      const auto& rule = rules_[i];
+      if (!is_enabled(rule.mode)) {
+        continue;
+      }
+      auto linked_row = row;
+      if (rule.link != -1) {
+        if (linked_rows[rule.link] == -1) {
+          linked_rows[rule.link] =
+              linkedRow(store, rows_by_kks, row, rule.link);
+        }
+        linked_row = linked_rows[rule.link];
+      }
+      if (!matches(store, row, linked_row, rule)) {
+        continue;
+      }
+      report(rule.mode,
+             format(store, row, linked_row, rule.message),
+             colors_.mid(rule.first_color, rule.color_count));
+      i = rule.group_end - 1;
+    }
+  }
+
+private:
+  // Text split into literal parts and operand references
+  struct TextPart {
+    QString text;
+    int column;
+    bool linked;
+    // The value is converted to an integer and the offset is added
+    bool numeric;
+    int offset;
+  };
+
+  struct Text {
+    int first_part = 0;
+    int part_count = 0;
+  };
+
+  // The conditions of ANY follow it, size counts the instruction and all of
+  // its conditions
+  struct Instruction {
+    FilterRule::Operation operation;
+    int column;
+    bool linked;
+    int other_column;
+    bool other_linked;
+    StringPool::Id value_id;
+    double number;
+    // -1 unless the value refers to the operands
+    int value_text;
+    int mask;
+    int size;
+  };
+
+  // Rules of a group are placed together, group_end is the index after the
+  // last rule of the group
+  struct CompiledRule {
+    int mode;
+    int group_end;
+    int link;
+    int first_instruction;
+    int instruction_count;
+    Text message;
+    int first_color;
+    int color_count;
+  };
+
+  Text compileText(const QString& text);
+  void compileCondition(const FilterRule::Condition& condition);
+  void addDependencies(const CompiledRule& rule);
+
+  int linkedRow(const PointStore& store,
+                const QHash<StringPool::Id, int>& rows_by_kks,
+                int row,
+                int link) const;
+  bool matches(const PointStore& store,
+               int row,
+               int linked_row,
+               const CompiledRule& rule) const;
+  bool test(const PointStore& store,
+            int row,
+            int linked_row,
+            const Instruction* instruction) const;
+  bool matchesMask(const PointStore& store,
+                   int row,
+                   const Instruction& instruction) const;
+  QString format(const PointStore& store,
+                 int row,
+                 int linked_row,
+                 const Text& text) const;
+
+  QVector<Instruction> instructions_;
+  QVector<TextPart> text_parts_;
+  QVector<Text> texts_;
+  QVector<Color> colors_;
+  QVector<QVector<QPair<QString, QString>>> links_;
+  QVector<WildcardMask> masks_;
+  // Results of the masks by value, filled by prepare()
+  QVector<QHash<StringPool::Id, bool>> mask_results_;
+  QVector<CompiledRule> rules_;
+  QHash<int, Dependencies> dependencies_;
+};
@@ -0,0 +1,135 @@
+#include "kksindex.h"
+
+#include <algorithm>
+
+void KksIndex::clear() {
+  rows_by_trigram_.clear();
+  rows_by_kks_.clear();
+  row_count_ = 0;
+}
+
+void KksIndex::update(const PointStore& store) {
+  if (store.size() < row_count_) {
+    clear();
+  }
+  auto first_new_row = row_count_;
+  for (auto row = first_new_row; row < store.size(); ++row) {
+    const auto& kks = store.value(row, PointInfo::Parameter::KKS);
+    for (int i = 0; i + 3 <= kks.size(); ++i) {
+      // Rows are added in increasing order, a repeated trigram of the same
+      // KKS is kept once
+      auto& rows = rows_by_trigram_[trigram(kks.constData() + i)];
+      if (rows.isEmpty() || rows.last() != row) {
+        rows.append(row);
+      }
+    }
+    rows_by_kks_.append(row);
+  }
+  row_count_ = store.size();
+
+  auto kksLess = [&store](int left, int right) {
+    return store.value(left, PointInfo::Parameter::KKS)
+        < store.value(right, PointInfo::Parameter::KKS);
+  };
+  auto middle = rows_by_kks_.begin() + first_new_row;
+  std::sort(middle, rows_by_kks_.end(), kksLess);
+  std::inplace_merge(rows_by_kks_.begin(), middle, rows_by_kks_.end(),
+                     kksLess);
+}
+
+QBitArray KksIndex::find(const PointStore& store,
+                         const WildcardMask& mask,
+                         const QBitArray* within) const {
+  QBitArray result(store.size());
+  bool all_rows = false;
+  auto rows = candidateRows(store, mask, all_rows);
+  auto check = [&](int row) {
+    if (within && (row >= within->size() || !within->testBit(row))) {
+      return;
+    }
+    if (mask.matches(store.value(row, PointInfo::Parameter::KKS))) {
+      result.setBit(row);
+    }
+  };
+  if (all_rows) {
+    for (int row = 0; row < store.size(); ++row) {
+      check(row);
+    }
+  } else {
+    for (auto row : rows) {
+      check(row);
+    }
+  }
+  return result;
+}
+
+quint64 KksIndex::trigram(const QChar* chars) {
+  return (static_cast<quint64>(chars[0].unicode()) << 32)
+      | (static_cast<quint64>(chars[1].unicode()) << 16)
+      | chars[2].unicode();
+}
+
+QVector<int> KksIndex::candidateRows(const PointStore& store,
+                                     const WildcardMask& mask,
+                                     bool& all_rows) const {
+  all_rows = false;
+  // Rows not indexed yet are checked against the mask as they are
+  auto addUnindexed = [&store, this](QVector<int>& rows) {
+    for (auto row = row_count_; row < store.size(); ++row) {
+      rows.append(row);
+    }
+  };
+
+  // The shortest posting lists are intersected first
+  QVector<const QVector<int>*> lists;
+  for (const auto& literal : mask.literals()) {
+    for (int i = 0; i + 3 <= literal.size(); ++i) {
+      auto it = rows_by_trigram_.constFind(trigram(literal.constData() + i));
+      if (it == rows_by_trigram_.constEnd()) {
+        QVector<int> rows;
+        addUnindexed(rows);
+        return rows;
+      }
+      lists.append(&*it);
+    }
+  }
+  if (!lists.isEmpty()) {
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int>* left, const QVector<int>* right) {
+      return left->size() < right->size();
+    });
+    auto rows = *lists.first();
+    for (int i = 1; i < lists.size() && !rows.isEmpty(); ++i) {
+      QVector<int> intersection;
+      std::set_intersection(rows.begin(), rows.end(),
+                            lists[i]->begin(), lists[i]->end(),
+                            std::back_inserter(intersection));
+      rows.swap(intersection);
+    }
+    addUnindexed(rows);
+    return rows;
+  }
+
+  auto prefix = mask.prefix();
+  if (!prefix.isEmpty()) {
+    auto kks = [&store](int row) -> const QString& {
+      return store.value(row, PointInfo::Parameter::KKS);
+    };
+    auto first = std::lower_bound(
+          rows_by_kks_.begin(), rows_by_kks_.end(), prefix,
+          [&kks](int row, const QString& value) {
+      return kks(row) < value;
+    });
+    QVector<int> rows;
+    for (auto it = first;
+         it != rows_by_kks_.end() && kks(*it).startsWith(prefix); ++it) {
+      rows.append(*it);
+    }
+    std::sort(rows.begin(), rows.end());
+    addUnindexed(rows);
+    return rows;
+  }
+
+  all_rows = true;
+  return {};
+}
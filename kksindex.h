@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QVector>
+
+#include "pointstore.h"
+#include "wildcardmask.h"
+
+// Search index over the KKS of the points. Rows are indexed as the store
+// grows. A query takes the candidate rows from the trigrams of the plain
+// parts of the mask, or from the rows sorted by KKS for a mask with a plain
+// prefix, and only checks the candidates against the mask.
+class KksIndex {
+public:
+  void clear();
+  // Indexes the rows added to the store since the last update
+  void update(const PointStore& store);
+
+  // Rows whose KKS matches the mask. If within is given only its rows are
+  // checked, which refines an earlier result.
+  QBitArray find(const PointStore& store,
+                 const WildcardMask& mask,
+                 const QBitArray* within = nullptr) const;
+
+private:
+  static quint64 trigram(const QChar* chars);
+
+  QVector<int> candidateRows(const PointStore& store,
+                             const WildcardMask& mask,
+                             bool& all_rows) const;
+
+  QHash<quint64, QVector<int>> rows_by_trigram_;
+  QVector<int> rows_by_kks_;
+  int row_count_ = 0;
+};
@@ -1,39 +1,54 @@
 #include "loader.h"
 
 #include <cmath>
+#include <limits>
 
+#include <QAtomicInt>
 #include <QFile>
-#include <QTextStream>
-#include <QRegularExpression>
+#include <QThread>
 #include <QDir>
 #include <QDirIterator>
 
+#include "bytescanner.h"
+#include "dbidparser.h"
+#include "mappedfile.h"
 #include "point.h"
-#include "treeitem.h"
+#include "srcmatcher.h"
+#include "srctokenizer.h"
+#include "stringpool.h"
 
+#include "globalsettings.h"
 #include "threadrunner.h"
 
 #include <QDebug>
 
-Loader::Loader(QObject* parent) : QObject(parent) {}
+Loader::Loader(QObject* parent) : QObject(parent) {
+  if (global_settings["SrcWorkerCount"].isDouble()) {
+    src_worker_count = global_settings["SrcWorkerCount"].toInt();
+  }
+}
 
 void Loader::loadDbid(const QString& dbid_file_path) {
   emit updateStatus("Обработка DBID. Подождите...");
-//  ThreadRunner::ThreadRunner([this, &dbid_file_path] {
-  QFile file(dbid_file_path);
-  file.open(QIODevice::ReadOnly | QIODevice::Text);
-  QTextStream stream(&file);
-
-  auto content = stream.readAll();
-  auto pos = content.indexOf('\n') + 1;
-
-  rootItem = new DbidTreeItem();
-  currentItem = rootItem;
-  while (dbidGetEntityType(content, pos) == dbidEntityType::object) {
-    dbidReadObject(content, pos);
+  dbidTree = QSharedPointer<DbidTree>::create();
+  plantTopology = QSharedPointer<PlantTopology>::create();
+  MappedFile file(dbid_file_path);
+  if (!file.isOpen()) {
+    emit updateStatus("Не удалось открыть DBID: " + dbid_file_path);
+    return;
   }
-//  });
+
+  DbidTree::Builder builder(*dbidTree, file);
+  DbidParser(file.data(), file.size()).parse(builder, [this](int percent) {
+    emit updateProgress(Source::DBID, percent);
+  });
+  builder.finish();
+  *plantTopology = PlantTopology::build(*dbidTree);
   emit updateStatus("Обработка DBID. Подождите... Завершено");
+  if (plantTopology->dropCount() == 0) {
+    emit updateStatus("В DBID не найдены станции (Drop), модули и таски "
+                      "не проверяются");
+  }
 }
 
 Loader::PointsContainer Loader::loadSrc(const QString& src_folder_path) {
@@ -43,101 +58,182 @@ Loader::PointsContainer Loader::loadSrc(const QString& src_folder_path) {
 //    srcPoints.clear();
     srcBackgroundErrors.clear();
     auto file_list = fileList(src_folder_path, "src");
-    int current_file_count = 0;
-    for (const auto& file_path : file_list) {
-      QFile file(file_path);
-      file.open(QIODevice::ReadOnly | QIODevice::Text);
-      QTextStream stream(&file);
-      auto content = stream.readAll();
-      auto file_name = QFileInfo(file_path).fileName();
-
-      removeComments(content);
-      removeQuotes(content);
-
-      auto line_positions = getLinesPositions(content);
-
-      int background_begin_pos =
-          content.indexOf("BACKGROUND", 0, Qt::CaseInsensitive);
-      int background_end_pos = content.length();
-      if (background_begin_pos != -1) {
-        for (const auto& search_text : {"FOREGROUND",
-                        "TRIGGER",
-                        "MACRO_TRIGGER",
-                        "KEYBOARD"}) {
-          auto t_background_end_pos = content.indexOf(
-                search_text, background_begin_pos, Qt::CaseInsensitive);
-          if (t_background_end_pos != -1
-              && (t_background_end_pos < background_end_pos)) {
-            background_end_pos = t_background_end_pos;
-          }
-        }
+    QVector<SrcFileResult> results(file_list.size());
+    auto results_data = results.data();
+    QAtomicInt next_file = 0;
+    QAtomicInt processed_file_count = 0;
+    const SrcMatcher matcher;
+    auto worker = [&] {
+      int index;
+      while ((index = next_file.fetchAndAddRelaxed(1)) < file_list.size()) {
+        results_data[index] = scanSrcFile(file_list[index], matcher);
+        emit updateProgress(
+                    Source::SRC,
+                    std::lround(100.0 * (processed_file_count
+                                         .fetchAndAddRelaxed(1) + 1)
+                                / file_list.size()));
+      }
+    };
+    ThreadRunner::runWorkers(
+          std::min(getSrcWorkerCount(), file_list.size()), worker);
+
+    auto& string_pool = StringPool::instance();
+    for (const auto& result : results) {
+      srcBackgroundErrors += result.background_errors;
+      auto file_name = string_pool.internString(result.file_name);
+      for (const auto& kks : result.points_kks) {
+        QHash<PointInfo::Parameter, QString> parameters;
+        parameters[PointInfo::Parameter::KKS] = string_pool.internString(kks);
+        parameters[PointInfo::Parameter::APPEAR_IN_FILES] = file_name;
+        srcPoints.append(parameters);
+      }
+    }
+    emit updateStatus("Обработка файлов графики (src). Подождите... Завершено");
+  }
+  return srcPoints;
+}
+
+void Loader::setSrcWorkerCount(int count) {
+  src_worker_count = count;
+}
+
+int Loader::getSrcWorkerCount() const {
+  if (src_worker_count > 0) {
+    return src_worker_count;
+  }
+  return std::max(QThread::idealThreadCount(), 1);
+}
+
+Loader::SrcFileResult Loader::scanSrcFile(const QString& file_path,
+                                          const SrcMatcher& matcher) {
+  SrcFileResult result;
+  MappedFile file(file_path);
+  result.file_name = QFileInfo(file_path).fileName();
+  if (!checkScannedSize(file, file_path)) {
+    return result;
+  }
+  auto data = file.data();
+  auto size = static_cast<int>(file.size());
+
+  int background_begin_pos = -1;
+  int background_end_pos = size;
+  bool background_end_found = false;
+  QMap<int, QStringList> bg_errors;
+  QMap<int, QStringList> bg_definition_errors;
+  SrcLineCounter macro_lines(data);
+  SrcLineCounter definition_lines(data);
+
+  int kks_begin_pos = -1;
+  int kks_from = 0;
+  QByteArray kks_bytes;
+
+  SrcTokenizer tokenizer(data, size);
+  SrcTokenizer::Region region;
+  while (tokenizer.next(region)) {
+    if (region.type != SrcTokenizer::RegionType::CODE) {
+      continue;
+    }
+
+    if (background_begin_pos == -1) {
+      background_begin_pos =
+          matcher.findBackground(data, region.begin, region.end);
+    }
+    if (background_begin_pos != -1 && !background_end_found) {
+      auto t_background_end_pos = matcher.findBackgroundEnd(
+            data, std::max(region.begin, background_begin_pos), region.end);
+      if (t_background_end_pos != -1) {
+        background_end_pos = t_background_end_pos;
+        background_end_found = true;
       }
-      QMap<int, QStringList> bg_errors;
-
-      if (background_begin_pos != -1) {
-        auto macro_pos = content.indexOf("Macro", background_begin_pos);
-        while (macro_pos != -1 && macro_pos < background_end_pos) {
-          QRegularExpression re("\\s+(\\d+)\\s");
-          auto macro_number = re.match(
-                content, macro_pos
-                + QString("Macro").length()).captured(1);
-          auto& line_background_errors =
-              bg_errors[posToLineNumber(macro_pos, line_positions)];
-          auto error = "Macro " + macro_number;
-          if (!line_background_errors.contains(error)) {
-            line_background_errors.append(error);
+    }
+
+    if (background_begin_pos != -1) {
+      auto macro_pos = matcher.findMacro(
+            data, std::max(region.begin, background_begin_pos), region.end);
+      while (macro_pos != -1 && macro_pos < background_end_pos) {
+        // The number is the first one after the keyword in the rest of the
+        // code, comments and quoted strings are skipped
+        auto number_pos = macro_pos + static_cast<int>(qstrlen("Macro"));
+        auto number_tokenizer = tokenizer;
+        auto number_region = region;
+        QString macro_number;
+        do {
+          if (number_region.type != SrcTokenizer::RegionType::CODE) {
+            continue;
           }
-          macro_pos = content.indexOf("Macro", macro_pos + 1);
+          int number_end;
+          auto number_begin = matcher.findMacroNumber(
+                data, std::max(number_pos, number_region.begin),
+                number_region.end, number_end);
+          if (number_begin != -1) {
+            macro_number = QString::fromLatin1(data + number_begin,
+                                               number_end - number_begin);
+            break;
+          }
+        } while (number_tokenizer.next(number_region));
+        auto& line_background_errors =
+            bg_errors[macro_lines.lineAt(macro_pos)];
+        auto error = "Macro " + macro_number;
+        if (!line_background_errors.contains(error)) {
+          line_background_errors.append(error);
         }
+        macro_pos = matcher.findMacro(data, macro_pos + 1, region.end);
       }
+    }
 
-      QSet<QString> points_kks;
-
-      auto pos = content.indexOf('\\');
-      while (pos != -1) {
-        auto end_pos = content.indexOf('\\', pos + 1);
-        auto kks = content.mid(pos + 1, end_pos - pos - 1).simplified();
+    // A KKS definition may run over several code regions, its text is
+    // the code between the two backslashes
+    if (kks_begin_pos != -1) {
+      kks_from = region.begin;
+    }
+    auto pos = region.begin;
+    while ((pos = ByteScanner::find(data, pos, region.end, '\\')) != -1) {
+      if (kks_begin_pos == -1) {
+        kks_begin_pos = pos;
+        kks_from = pos + 1;
+        kks_bytes.clear();
+      } else {
+        kks_bytes.append(data + kks_from, pos - kks_from);
+        auto kks = file.decode(kks_bytes.constData(), kks_bytes.size())
+            .simplified();
         if (kks.contains(' ')) {
           qFatal(qUtf8Printable(kks + " has whitespaces"));
         }
         if (!kks.startsWith('$') && kks != "________") {
-          if (!points_kks.contains(kks)) {
-            points_kks.insert(kks);
+          if (!result.points_kks.contains(kks)) {
+            result.points_kks.insert(kks);
           }
           if (background_begin_pos != -1
-              && pos > background_begin_pos
-              && pos < background_end_pos) {
+              && kks_begin_pos > background_begin_pos
+              && kks_begin_pos < background_end_pos) {
             auto& line_background_errors =
-                bg_errors[posToLineNumber(pos, line_positions)];
+                bg_definition_errors[definition_lines.lineAt(kks_begin_pos)];
             auto error = "Definition \\" + kks + "\\";
             if (!line_background_errors.contains(error)) {
               line_background_errors.append(error);
             }
           }
         }
-        pos = content.indexOf('\\', end_pos + 1);
-      }
-
-      if (!bg_errors.isEmpty()) {
-        for (auto it = bg_errors.keyValueBegin();
-             it != bg_errors.keyValueEnd(); ++it) {
-          srcBackgroundErrors.append({file_name, (*it).first, (*it).second});
-        }
-//        srcBackgroundErrors[file_name] = background_errors;
+        kks_begin_pos = -1;
       }
-
-      for (const auto& kks : points_kks) {
-        QHash<PointInfo::Parameter, QString> parameters;
-        parameters[PointInfo::Parameter::KKS] = kks;
-        parameters[PointInfo::Parameter::APPEAR_IN_FILES] = file_name;
-        srcPoints.append(parameters);
-      }
-      emit updateProgress(
-                  std::lround(100.0 * ++current_file_count / file_list.size()));
+      ++pos;
+    }
+    if (kks_begin_pos != -1) {
+      kks_bytes.append(data + kks_from, region.end - kks_from);
     }
-    emit updateStatus("Обработка файлов графики (src). Подождите... Завершено");
   }
-  return srcPoints;
+
+  for (auto it = bg_definition_errors.keyValueBegin();
+       it != bg_definition_errors.keyValueEnd(); ++it) {
+    bg_errors[(*it).first] += (*it).second;
+  }
+  for (auto it = bg_errors.keyValueBegin();
+       it != bg_errors.keyValueEnd(); ++it) {
+    result.background_errors.append(
+                {result.file_name, (*it).first, (*it).second});
+  }
+
+  return result;
 }
 
 Loader::PointsContainer Loader::loadXml(const QString& xml_folder_path) {
@@ -146,33 +242,46 @@ Loader::PointsContainer Loader::loadXml(const QString& xml_folder_path) {
     emit updateStatus("Обработка файлов логики (xml). Подождите...");
 //    xmlPoints.clear();
     auto file_list = fileList(xml_folder_path, "xml");
+    auto& string_pool = StringPool::instance();
     int current_file_count = 0;
     for (const auto& file_path : file_list) {
-      QFile file(file_path);
-      file.open(QIODevice::ReadOnly | QIODevice::Text);
-      QTextStream stream(&file);
-      auto content = stream.readAll();
-      auto file_name = QFileInfo(file_path).fileName();
-
-      QString search_text = R"(point=")";
-      int pos =  content.indexOf(search_text);
+      MappedFile file(file_path);
+      if (!checkScannedSize(file, file_path)) {
+        continue;
+      }
+      auto data = file.data();
+      auto size = static_cast<int>(file.size());
+      auto file_name = string_pool.internString(
+            QFileInfo(file_path).fileName());
+
+      const char search_text[] = R"(point=")";
+      const int search_text_size = sizeof(search_text) - 1;
+      int pos = ByteScanner::find(data, 0, size,
+                                  search_text, search_text_size);
       QSet<QString> points_kks;
 
       while (pos != -1) {
-        pos += search_text.length();
-        if ((content.at(pos) != '"') && (content.mid(pos, 3) != "OCB")) {
-          points_kks.insert(content.mid(pos, content.indexOf('"', pos) - pos));
+        pos += search_text_size;
+        auto kks_end = ByteScanner::find(data, pos, size, '"');
+        if (kks_end == -1) {
+          kks_end = size;
         }
-        pos = content.indexOf(search_text, pos);
+        if (kks_end != pos
+            && !(kks_end - pos >= 3 && qstrncmp(data + pos, "OCB", 3) == 0)) {
+          points_kks.insert(file.decode(data + pos, kks_end - pos));
+        }
+        pos = ByteScanner::find(data, pos, size,
+                                search_text, search_text_size);
       }
 
       for (const auto& kks : points_kks) {
         QHash<PointInfo::Parameter, QString> parameters;
-        parameters[PointInfo::Parameter::KKS] = kks;
+        parameters[PointInfo::Parameter::KKS] = string_pool.internString(kks);
         parameters[PointInfo::Parameter::APPEAR_IN_FILES] = file_name;
         xmlPoints.append(parameters);
       }
       emit updateProgress(
+                  Source::XML,
                   std::lround(100.0 * ++current_file_count / file_list.size()));
     }
     emit updateStatus("Обработка файлов логики (xml). Подождите... Завершено");
@@ -183,18 +292,32 @@ Loader::PointsContainer Loader::loadXml(const QString& xml_folder_path) {
 Loader::PointsContainer Loader::loadOphxml(const QString& ophxml_file_path) {
   QVector<QHash<PointInfo::Parameter, QString>> ophxmlPoints;
   emit updateStatus("Обработка OPHXML файла. Подождите...");
-  QFile file(ophxml_file_path);
-  file.open(QIODevice::ReadOnly | QIODevice::Text);
-  QTextStream stream(&file);
-  auto file_name = QFileInfo(ophxml_file_path).fileName();
-
-  auto content = stream.readAll();
-
-  auto scangroup_freq_decl = QString(R"(ScanGroup_Frequency=")");
-  auto point_name_decl = QString(R"(Point_Name=")");
-
-  auto scangroup_freq_pos = content.indexOf(scangroup_freq_decl);
-  auto point_name_pos = content.indexOf(point_name_decl);
+  MappedFile file(ophxml_file_path);
+  if (!checkScannedSize(file, ophxml_file_path)) {
+    return ophxmlPoints;
+  }
+  auto& string_pool = StringPool::instance();
+  auto file_name = string_pool.internString(
+        QFileInfo(ophxml_file_path).fileName());
+
+  auto data = file.data();
+  auto size = static_cast<int>(file.size());
+  auto valueEnd = [data, size](int from, char delimiter) {
+    auto end = ByteScanner::find(data, from, size, delimiter);
+    return end != -1 ? end : size;
+  };
+
+  const char scangroup_freq_decl[] = R"(ScanGroup_Frequency=")";
+  const int scangroup_freq_decl_size = sizeof(scangroup_freq_decl) - 1;
+  const char point_name_decl[] = R"(Point_Name=")";
+  const int point_name_decl_size = sizeof(point_name_decl) - 1;
+
+  auto scangroup_freq_pos = ByteScanner::find(data, 0, size,
+                                              scangroup_freq_decl,
+                                              scangroup_freq_decl_size);
+  auto point_name_pos = ByteScanner::find(data, 0, size,
+                                          point_name_decl,
+                                          point_name_decl_size);
   QString freq, point_name;
 
 
@@ -202,23 +325,29 @@ Loader::PointsContainer Loader::loadOphxml(const QString& ophxml_file_path) {
 
 //  ophxmlPoints.clear();
   while (pos != -1) {
-    if (content[pos] == scangroup_freq_decl[0]) {
-      pos += scangroup_freq_decl.length();
-      freq = content.mid(pos, content.indexOf('"', pos) - pos);
+    if (data[pos] == scangroup_freq_decl[0]) {
+      pos += scangroup_freq_decl_size;
+      freq = file.decode(data + pos, valueEnd(pos, '"') - pos);
     } else {
-      pos += point_name_decl.length();
-      point_name = content.mid(pos, content.indexOf('.', pos) - pos);
+      pos += point_name_decl_size;
+      point_name = file.decode(data + pos, valueEnd(pos, '.') - pos);
       QHash<PointInfo::Parameter, QString> parameters;
-      parameters[PointInfo::Parameter::KKS] = point_name;
+      parameters[PointInfo::Parameter::KKS] =
+          string_pool.internString(point_name);
       parameters[PointInfo::Parameter::APPEAR_IN_FILES] = file_name;
-      parameters[PointInfo::Parameter::SCANGROUP_FREQUENCY] = freq;
+      parameters[PointInfo::Parameter::SCANGROUP_FREQUENCY] =
+          string_pool.internString(freq);
       ophxmlPoints.append(parameters);
     }
 
-    scangroup_freq_pos = content.indexOf(scangroup_freq_decl, pos);
-    point_name_pos = content.indexOf(point_name_decl, pos);
+    scangroup_freq_pos = ByteScanner::find(data, pos, size,
+                                           scangroup_freq_decl,
+                                           scangroup_freq_decl_size);
+    point_name_pos = ByteScanner::find(data, pos, size,
+                                       point_name_decl,
+                                       point_name_decl_size);
     pos = getFirstIndex(scangroup_freq_pos, point_name_pos);
-    emit updateProgress(std::lround(100.0 * pos / content.size()));
+    emit updateProgress(Source::OPHXML, std::lround(100.0 * pos / size));
   }
 
   emit updateStatus("Обработка OPHXML файла. Подождите... Завершено");
@@ -226,120 +355,17 @@ Loader::PointsContainer Loader::loadOphxml(const QString& ophxml_file_path) {
 }
 
 void Loader::clear() {
-  delete rootItem;
+  dbidTree.reset();
+  plantTopology.reset();
   srcBackgroundErrors.clear();
 }
 
-Loader::DbidTreeItem* Loader::getDbidTreeRootItem() {
-  return rootItem;
-}
-
-Loader::dbidEntityType Loader::dbidGetEntityType(QString& content, int& pos) {
-  while (content[pos].isSpace()) {++pos;}
-  auto ch = content[pos++];
-  while (content[pos].isSpace()) {++pos;}
-  if (ch == '(') {
-    return dbidEntityType::object;
-  } else if (ch == '[') {
-    return dbidEntityType::array;
-  } else {
-    return dbidEntityType::undefined;
-  }
-}
-
-void Loader::dbidReadObject(QString& content, int& pos) {
-
-  auto type_pair = dbidReadParameter(content, pos);
-  auto type_keyword = type_pair.first;
-  auto type = type_pair.second;
-
-  auto name_pair = dbidReadParameter(content, pos);
-  auto name_keyword = name_pair.first;
-  auto name = name_pair.second;
-
-  auto parent = currentItem;
-  currentItem->children.append(new DbidTreeItem());
-  currentItem = currentItem->children.last();
-  currentItem->parameter = name;
-  currentItem->value = type;
-
-  while (true) {
-    if (content[pos] == ')') {
-      ++pos;
-      while (content[pos].isSpace()) {++pos;}
-      break;
-    }
-    auto operation = dbidGetEntityType(content, pos);
-    if (operation == dbidEntityType::array) {
-      int row = 0;
-      while (true) {
-        if (content[pos] == ']') {
-          ++pos;
-          while (content[pos].isSpace()) {++pos;}
-          break;
-        }
-        currentItem->children.append(new DbidTreeItem());
-        auto item = currentItem->children.last();
-
-        auto parameter_pair = dbidReadParameter(content, pos);
-        auto parameter_name = parameter_pair.first;
-        auto parameter_value = parameter_pair.second;
-        item->parameter = parameter_name;
-        item->value = parameter_value;
-        ++row;
-      }
-    } else if (operation == dbidEntityType::object) {
-      dbidReadObject(content, pos);
-    }
-  }
-
-  currentItem = parent;
-
-  emit updateProgress(std::lround(100.0 * pos / content.size()));
-}
-
-QPair<QString, QString> Loader::dbidReadParameter(QString& content, int& pos) {
-  auto parameter_name = dbidReadKeyword(content, pos);
-  if (parameter_name.isEmpty()) {
-    qFatal("Parameter name is empty");
-  }
-  while (content[pos].isSpace()) {++pos;}
-  if (content[pos++] != '=') {
-    qFatal("Unexpected character. Expected '='");
-  }
-  while (content[pos].isSpace()) {++pos;}
-  auto parameter_value = dbidReadValue(content, pos);
-  while (content[pos].isSpace()) {++pos;}
-  return QPair(parameter_name, parameter_value);
+QSharedPointer<const DbidTree> Loader::getDbidTree() const {
+  return dbidTree;
 }
 
-QString Loader::dbidReadKeyword(QString& content, int& pos) {
-  QString keyword;
-  QChar ch;
-
-  while (static_cast<void>(ch = content[pos]),
-         ch.isLetter()
-         || ch.isDigit()
-         || ch == '.'
-         || ch == '_'
-         || ch == '-') {
-    keyword += ch;
-    ++pos;
-  }
-
-  return keyword;
-}
-
-QString Loader::dbidReadValue(QString& content, int& pos) {
-  if (content[pos++] != '"') {
-    qFatal("Error. Expected quote");
-  }
-  QString value;
-  while (content[pos] != '"') {
-    value += content[pos++];
-  }
-  ++pos;
-  return value;
+QSharedPointer<const PlantTopology> Loader::getPlantTopology() const {
+  return plantTopology;
 }
 
 QVector<QString> Loader::fileList(
@@ -359,58 +385,13 @@ QVector<QString> Loader::fileList(
   return container;
 }
 
-QVector<int> Loader::getLinesPositions(QString& content) {
-  QVector<int> result;
-  int pos = 0;
-  while (pos != -1) {
-    result.append(pos + 1);
-    pos = content.indexOf('\n', pos + 1);
-  }
-  return result;
-}
-
-int Loader::posToLineNumber(int pos, const QVector<int>& linesPositions) {
-  int line = 0;
-  for (const auto line_position : linesPositions) {
-    if (pos < line_position) {
-      return line;
-    }
-    line++;
-  }
-  qFatal("pos out of range");
-}
-
-void Loader::removeComments(QString& content) {
-  int pos = content.indexOf('*');
-
-  while (pos != -1) {
-    auto end_pos = content.indexOf('\n', pos);
-    if (end_pos == -1) {
-      end_pos = content.size();
-    }
-    content.remove(pos, end_pos - pos);
-    pos = content.indexOf('*', pos + 1);
-  }
-}
-
-void Loader::removeQuotes(QString& content) {
-  auto pos = getFirstIndex(content.indexOf('"'), content.indexOf('\''));
-
-  while (pos != -1) {
-    QChar quote = content[pos];
-    auto next_quote_pos = content.indexOf(quote, pos + 1);
-    if (next_quote_pos == -1) {
-      qFatal("Not closed quotes");
-    }
-    auto new_line_count = content.midRef(pos, next_quote_pos - pos).count('\n');
-    content.remove(pos + 1, next_quote_pos - pos - 1);
-    for (int i = 0; i < new_line_count; ++i) {
-      content.insert(pos + 1, '\n');
-    }
-    pos = getFirstIndex(
-                content.indexOf('"', pos + new_line_count + 2),
-                content.indexOf('\'', pos + new_line_count + 2));
+bool Loader::checkScannedSize(const MappedFile& file,
+                              const QString& file_path) {
+  if (file.size() > std::numeric_limits<int>::max()) {
+    emit updateStatus("Файл больше 2 ГБ пропущен: " + file_path);
+    return false;
   }
+  return true;
 }
 
 int Loader::getFirstIndex(const int& left, const int& right) {
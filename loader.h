@@ -1,27 +1,40 @@
 #pragma once
 
+#include <QSet>
+#include <QSharedPointer>
+
+#include "dbidtree.h"
+#include "planttopology.h"
+#include "srcmatcher.h"
 #include "point.h"
 
 #include "srcbgproxymodel.h"
 
+class MappedFile;
+
 class Loader : public QObject {
   Q_OBJECT
 public:
   Loader(QObject *parent = nullptr);
 
+  // The sources are read at the same time, their progress is told apart
+  enum class Source {
+    DBID, SRC, XML, OPHXML
+  };
+  Q_ENUM(Source)
+
   void loadDbid(const QString &dbid_file_path);
   using PointsContainer = QVector<QHash<PointInfo::Parameter, QString>>;
   PointsContainer loadSrc(const QString &src_folder_path);
+  // 0 means one worker per core, 1 scans the files serially
+  void setSrcWorkerCount(int count);
+  int getSrcWorkerCount() const;
   PointsContainer loadXml(const QString &xml_folder_path);
   PointsContainer loadOphxml(const QString &ophxml_folder_path);
   void clear();
 
-  struct DbidTreeItem {
-    QString parameter, value;
-    QList<DbidTreeItem*> children;
-  };
-
-  DbidTreeItem* getDbidTreeRootItem();
+  QSharedPointer<const DbidTree> getDbidTree() const;
+  QSharedPointer<const PlantTopology> getPlantTopology() const;
 //  QVector<QHash<PointInfo::Parameter, QString>> getAllPoints();
 
 //  QVector<QHash<PointInfo::Parameter, QString>> pointsContainerFromDbidTreeModel();
@@ -35,29 +48,30 @@ public:
 
 signals:
   void updateStatus(const QString& status, int timeout = 0);
-  void updateProgress(int percent);
+  void updateProgress(Loader::Source source, int percent);
 
 private:
 
-  enum class dbidEntityType {
-    object, array, undefined
-  };
+  QSharedPointer<DbidTree> dbidTree;
+  QSharedPointer<PlantTopology> plantTopology;
 
-  DbidTreeItem *rootItem = nullptr, *currentItem = nullptr;
+  int src_worker_count = 0;
 
+  struct SrcFileResult {
+    QString file_name;
+    QSet<QString> points_kks;
+    QList<SrcBGProxyModel::DataModel::Data> background_errors;
+  };
 
-  dbidEntityType dbidGetEntityType(QString& content, int& pos);
-  void dbidReadObject(QString& content, int& pos);
-  QPair<QString, QString> dbidReadParameter(QString& content, int& pos);
-  QString dbidReadKeyword(QString& content, int& pos);
-  QString dbidReadValue(QString& content, int& pos);
+  SrcFileResult scanSrcFile(const QString& file_path,
+                            const SrcMatcher& matcher);
 
-  QVector<int> getLinesPositions(QString& content);
-  int posToLineNumber(int pos, const QVector<int>& linesPositions);
-  void removeComments(QString& content);
-  void removeQuotes(QString& content);
   int getFirstIndex(const int& left, const int& right);
 
+  // The SRC and XML scanners use int offsets, larger files are reported and
+  // skipped
+  bool checkScannedSize(const MappedFile& file, const QString& file_path);
+
   QVector<QString> fileList(const QString& path, const QString& extension);
 
 };
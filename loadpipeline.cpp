@@ -0,0 +1,60 @@
+#include "loadpipeline.h"
+
+LoadPipeline::LoadPipeline() : state(QSharedPointer<State>::create()) {}
+
+LoadPipeline::Stage LoadPipeline::addStage(
+    const std::function<void ()>& run,
+    const QVector<Stage>& dependencies) {
+  Stage stage = state->stages.size();
+  state->stages.append({});
+  state->stages[stage].run = run;
+  for (auto dependency : dependencies) {
+    Q_ASSERT(dependency >= 0 && dependency < stage);
+    state->stages[dependency].dependents.append(stage);
+    ++state->stages[stage].dependency_count;
+  }
+  return stage;
+}
+
+void LoadPipeline::start(const std::function<void ()>& finished,
+                         const ThreadRunner::CancellationToken& token) {
+  state->finished = finished;
+  state->token = token;
+  state->pending_stages = state->stages.size();
+  if (state->stages.isEmpty()) {
+    if (!token.isCancelled()) {
+      finished();
+    }
+    return;
+  }
+  for (auto& stage_data : state->stages) {
+    stage_data.pending_dependencies = stage_data.dependency_count;
+  }
+  auto pipeline_state = state;
+  state.reset();
+  const auto& stages = pipeline_state->stages;
+  for (Stage stage = 0; stage < stages.size(); ++stage) {
+    if (stages[stage].dependency_count == 0) {
+      schedule(pipeline_state, stage);
+    }
+  }
+}
+
+void LoadPipeline::schedule(const QSharedPointer<State>& state, Stage stage) {
+  ThreadRunner::run([state, stage] {
+    const auto& stages = state->stages;
+    // A skipped stage still releases its dependents, so every stage is
+    // accounted for
+    if (!state->token.isCancelled()) {
+      stages[stage].run();
+    }
+    for (auto dependent : stages[stage].dependents) {
+      if (!stages[dependent].pending_dependencies.deref()) {
+        schedule(state, dependent);
+      }
+    }
+    if (!state->pending_stages.deref() && !state->token.isCancelled()) {
+      state->finished();
+    }
+  });
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "threadrunner.h"
+
+// Runs load stages on the shared thread pool as soon as the stages they
+// depend on are done. Nothing waits for the stages: the stage which
+// completes last calls the finished callback on its own thread. Once the
+// token is cancelled the stages which have not started yet are skipped and
+// the finished callback is not called.
+class LoadPipeline {
+public:
+  using Stage = int;
+
+  LoadPipeline();
+
+  Stage addStage(const std::function<void ()>& run,
+                 const QVector<Stage>& dependencies = {});
+  // The pipeline may be destroyed right after the call
+  void start(const std::function<void ()>& finished,
+             const ThreadRunner::CancellationToken& token = {});
+
+private:
+  struct StageData {
+    std::function<void ()> run;
+    QVector<Stage> dependents;
+    int dependency_count = 0;
+    // Stages are shared read-only between the workers once started
+    mutable QAtomicInt pending_dependencies;
+  };
+
+  struct State {
+    QVector<StageData> stages;
+    QAtomicInt pending_stages;
+    std::function<void ()> finished;
+    ThreadRunner::CancellationToken token;
+  };
+
+  static void schedule(const QSharedPointer<State>& state, Stage stage);
+
+  QSharedPointer<State> state;
+};
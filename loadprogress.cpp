@@ -0,0 +1,44 @@
+#include "loadprogress.h"
+
+#include <QMetaEnum>
+#include <QStringList>
+
+LoadProgress::LoadProgress(QObject* parent) : QObject(parent) {}
+
+void LoadProgress::start(const QVector<Loader::Source>& sources) {
+  progress.clear();
+  for (auto source : sources) {
+    progress.insert(source, 0);
+  }
+  update();
+}
+
+void LoadProgress::setProgress(Loader::Source source, int percent) {
+  auto it = progress.find(source);
+  if (it != progress.end()) {
+    *it = percent;
+    update();
+  }
+}
+
+void LoadProgress::finish() {
+  progress.clear();
+  emit updateFormat("%p%");
+}
+
+void LoadProgress::update() {
+  if (progress.isEmpty()) {
+    return;
+  }
+  auto names = QMetaEnum::fromType<Loader::Source>();
+  QStringList format;
+  int total = 0;
+  for (auto it = progress.cbegin(); it != progress.cend(); ++it) {
+    format += QString("%1 %2%")
+              .arg(names.valueToKey(static_cast<int>(it.key())))
+              .arg(it.value());
+    total += it.value();
+  }
+  emit updateFormat(format.join("  "));
+  emit updateProgress(total / progress.size());
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QMap>
+#include <QObject>
+
+#include "loader.h"
+
+// Progress of the sources which are read at the same time. Every source
+// reports its own percent, the progress bar shows the mean of the sources of
+// the load and the text lists the percent of each of them.
+class LoadProgress : public QObject {
+  Q_OBJECT
+public:
+  explicit LoadProgress(QObject* parent = nullptr);
+
+  // Called before the load starts, the other sources are ignored
+  void start(const QVector<Loader::Source>& sources);
+  void setProgress(Loader::Source source, int percent);
+  void finish();
+
+signals:
+  void updateProgress(int percent);
+  void updateFormat(const QString& format);
+
+private:
+  void update();
+
+  QMap<Loader::Source, int> progress;
+};
@@ -3,14 +3,18 @@
 #include <QFileDialog>
 #include <QToolButton>
 #include <QHeaderView>
+#include <QMessageBox>
 #include <QTimer>
 #include <QJsonDocument>
 
 #include <xlsxdocument.h>
 
+#include "loadpipeline.h"
+#include "loadprogress.h"
 #include "threadrunner.h"
 #include "loader.h"
 #include "point.h"
+#include "stringpool.h"
 
 #include "globalsettings.h"
 #include <QJsonArray>
@@ -33,6 +37,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent)
   }
   setupModels();
   loader = new Loader(this);
+  loadProgress = new LoadProgress(this);
   filter_option_dialogs_ = {
     {PointsTableModel::FilterMode::CHARACTERISTICS_ERRORS,
      new CharacteristicsDialog(tableModel, this)},
@@ -45,6 +50,34 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent)
   connectSignals();
 
   exportExcelDialog = new ExportExcelDialog(this);
+
+  if (!tableModel->invalidFilterRules().isEmpty()) {
+    QTimer::singleShot(0, this, [this] {
+      QMessageBox::warning(
+            this,
+            "FilterRules",
+            "Некорректные правила фильтрации из settings.json пропущены:\n"
+            + tableModel->invalidFilterRules().join('\n'));
+    });
+  }
+}
+
+MainWindow::~MainWindow() {
+  load_token.cancel();
+  QThreadPool::globalInstance()->waitForDone();
+}
+
+void MainWindow::saveStarted() {
+  ++running_saves;
+  loadButton->setDisabled(true);
+  reloadButton->setDisabled(true);
+}
+
+void MainWindow::saveFinished() {
+  if (--running_saves == 0) {
+    loadButton->setDisabled(false);
+    reloadButton->setDisabled(false);
+  }
 }
 
 void MainWindow::setupModels() {
@@ -191,6 +224,12 @@ void MainWindow::setupSideArea() {
   pathGroupBoxLayout->addWidget(loadButton,
                                 pathGroupBoxLayout->rowCount(), 0, 1, -1);
 
+  reloadButton = new QPushButton("Обновить отмеченные SRC, XML, OPHXML", this);
+  reloadButton->setToolTip("Повторное чтение источников без сброса "
+                           "остальных данных");
+  pathGroupBoxLayout->addWidget(reloadButton,
+                                pathGroupBoxLayout->rowCount(), 0, 1, -1);
+
   compareButton = new QPushButton("Сравнение DBID|Excel|AMS", this);
   pathGroupBoxLayout->addWidget(compareButton,
                                 pathGroupBoxLayout->rowCount(), 0, 1, -1);
@@ -369,66 +408,193 @@ void MainWindow::connectSignals() {
         widget->setDisabled(true);
       }
     }
-    ThreadRunner::ThreadRunner([this] {
-      auto dbid_path = dbidPathLineEdit->text();
-      auto src_path = srcPathLineEdit->text();
-      auto xml_path = xmlPathLineEdit->text();
-      auto ophxml_path = ophxmlPathLineEdit->text();
-      auto excel_path = excelPathLineEdit->text();
-      auto amsPath = amsPathLineEdit->text();
-      auto dbid_enabled = !dbid_path.isEmpty() && dbidCheckBox->isChecked();
-      auto src_enabled = !src_path.isEmpty() && srcCheckBox->isChecked();
-      auto xml_enabled = !xml_path.isEmpty() && xmlCheckBox->isChecked();
-      auto ophxml_enabled
-          = !ophxml_path.isEmpty() && ophxmlCheckBox->isChecked();
-      auto excel_enabled = !excel_path.isEmpty() && excelCheckBox->isChecked();
-      auto ams_enabled = !amsPath.isEmpty() && amsCheckBox->isChecked();
-      QVector<QHash<PointInfo::Parameter, QString>> container;
-      if (dbid_enabled
-          || src_enabled
-          || xml_enabled
-          || ophxml_enabled
-          || excel_enabled) {
-        emit updateStatus("Сброс данных. Подождите...");
-        loader->clear();
-        tableModel->clear();
-        treeModel->clear();
-        srcBGProxyModel->dataModel->clear();
-        excelPointsModel->clear();
-        amsModel->clear();
-        emit updateStatus("Сброс данных. Подождите... Завершено");
-      }
-      if (dbid_enabled) {
+    auto dbid_path = dbidPathLineEdit->text();
+    auto src_path = srcPathLineEdit->text();
+    auto xml_path = xmlPathLineEdit->text();
+    auto ophxml_path = ophxmlPathLineEdit->text();
+    auto excel_path = excelPathLineEdit->text();
+    auto amsPath = amsPathLineEdit->text();
+    auto dbid_enabled = !dbid_path.isEmpty() && dbidCheckBox->isChecked();
+    auto src_enabled = !src_path.isEmpty() && srcCheckBox->isChecked();
+    auto xml_enabled = !xml_path.isEmpty() && xmlCheckBox->isChecked();
+    auto ophxml_enabled
+        = !ophxml_path.isEmpty() && ophxmlCheckBox->isChecked();
+    auto excel_enabled = !excel_path.isEmpty() && excelCheckBox->isChecked();
+    auto ams_enabled = !amsPath.isEmpty() && amsCheckBox->isChecked();
+
+    QVector<Loader::Source> sources;
+    if (dbid_enabled) {
+      sources.append(Loader::Source::DBID);
+    }
+    if (src_enabled) {
+      sources.append(Loader::Source::SRC);
+    }
+    if (xml_enabled) {
+      sources.append(Loader::Source::XML);
+    }
+    if (ophxml_enabled) {
+      sources.append(Loader::Source::OPHXML);
+    }
+    loadProgress->start(sources);
+
+    // The models are reset on this thread, so the views, the proxies and
+    // the comparison drop their rows before the string pool is cleared and
+    // nothing reads an old id afterwards. The load stages start once the
+    // pool is empty.
+    if (dbid_enabled
+        || src_enabled
+        || xml_enabled
+        || ophxml_enabled
+        || excel_enabled) {
+      emit updateStatus("Сброс данных. Подождите...");
+      loader->clear();
+      tableModel->clear();
+      treeModel->clear();
+      srcBGProxyModel->dataModel->clear();
+      excelPointsModel->clear();
+      amsModel->clear();
+      StringPool::instance().clear();
+      emit updateStatus("Сброс данных. Подождите... Завершено");
+    }
+
+    // Every source is read by its own stage, the points are merged in the
+    // same order as before: DBID, SRC, XML, OPHXML
+    using Container = QVector<QHash<PointInfo::Parameter, QString>>;
+    auto containers = QSharedPointer<QVector<Container>>::create(4);
+    LoadPipeline pipeline;
+    QVector<LoadPipeline::Stage> points_stages;
+    if (dbid_enabled) {
+      auto dbid_stage = pipeline.addStage([=] {
         loader->loadDbid(dbid_path);
-        treeModel->loadFromDbidTree(loader->getDbidTreeRootItem());
-        container += tableModel->loadDbidRootItem(loader->getDbidTreeRootItem());
-      }
-      if (src_enabled) {
-        container += loader->loadSrc(src_path);
+      });
+      pipeline.addStage([=] {
+        treeModel->loadFromDbidTree(loader->getDbidTree(),
+                                    loader->getPlantTopology());
+      }, {dbid_stage});
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[0] =
+            tableModel->loadDbidRootItem(*loader->getDbidTree(),
+                                         loader->getPlantTopology());
+      }, {dbid_stage}));
+    }
+    if (src_enabled) {
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[1] = loader->loadSrc(src_path);
         srcBGProxyModel->dataModel->setBGErrors(loader->srcBackgroundErrors);
-      }
-      if (xml_enabled) {
-        container += loader->loadXml(xml_path);
-      }
-      if (ophxml_enabled) {
-        container += loader->loadOphxml(ophxml_path);
+      }));
+    }
+    if (xml_enabled) {
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[2] = loader->loadXml(xml_path);
+      }));
+    }
+    if (ophxml_enabled) {
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[3] = loader->loadOphxml(ophxml_path);
+      }));
+    }
+    pipeline.addStage([=] {
+      // The sources are read, the bar shows the progress of the model again
+      QMetaObject::invokeMethod(loadProgress, &LoadProgress::finish);
+      Container container;
+      for (auto& source_container : *containers) {
+        container += source_container;
+        source_container.clear();
       }
       tableModel->loadPoints(container);
       updateStatus("After tableModel->loadPoints(container)");
-      if (excel_enabled) {
+    }, points_stages);
+    if (excel_enabled) {
+      pipeline.addStage([=] {
         qDebug() << "Before load Excel";
         excelPointsModel->loadExcel(excel_path);
-      }
-      if (ams_enabled) {
-        amsModel->load(amsPathLineEdit->text());
-      }
+      });
+    }
+    if (ams_enabled) {
+      pipeline.addStage([=] {
+        amsModel->load(amsPath);
+      });
+    }
+    pipeline.start([=] {
       emit loadComplete(dbid_enabled,
                         src_enabled,
                         xml_enabled,
                         ophxml_enabled,
                         excel_enabled,
                         ams_enabled);
-    });
+    }, load_token);
+  });
+
+  // The points of the sources are merged into the loaded ones, only the
+  // changed rows and parameters are checked again. The points no longer in
+  // the sources are kept until the next load.
+  connect(reloadButton, &QPushButton::clicked, this, [this]() {
+    auto src_path = srcPathLineEdit->text();
+    auto xml_path = xmlPathLineEdit->text();
+    auto ophxml_path = ophxmlPathLineEdit->text();
+    auto src_enabled = !src_path.isEmpty() && srcCheckBox->isChecked();
+    auto xml_enabled = !xml_path.isEmpty() && xmlCheckBox->isChecked();
+    auto ophxml_enabled
+        = !ophxml_path.isEmpty() && ophxmlCheckBox->isChecked();
+    if (!src_enabled && !xml_enabled && !ophxml_enabled) {
+      return;
+    }
+    for (int i = 0; i < sideLayout->count(); ++i) {
+      auto widget = sideLayout->itemAt(i)->widget();
+      if (widget != nullptr) {
+        widget->setDisabled(true);
+      }
+    }
+    QVector<Loader::Source> sources;
+    if (src_enabled) {
+      sources.append(Loader::Source::SRC);
+    }
+    if (xml_enabled) {
+      sources.append(Loader::Source::XML);
+    }
+    if (ophxml_enabled) {
+      sources.append(Loader::Source::OPHXML);
+    }
+    loadProgress->start(sources);
+
+    using Container = QVector<QHash<PointInfo::Parameter, QString>>;
+    auto containers = QSharedPointer<QVector<Container>>::create(3);
+    LoadPipeline pipeline;
+    QVector<LoadPipeline::Stage> points_stages;
+    if (src_enabled) {
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[0] = loader->loadSrc(src_path);
+        srcBGProxyModel->dataModel->setBGErrors(loader->srcBackgroundErrors);
+      }));
+    }
+    if (xml_enabled) {
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[1] = loader->loadXml(xml_path);
+      }));
+    }
+    if (ophxml_enabled) {
+      points_stages.append(pipeline.addStage([=] {
+        (*containers)[2] = loader->loadOphxml(ophxml_path);
+      }));
+    }
+    pipeline.addStage([=] {
+      QMetaObject::invokeMethod(loadProgress, &LoadProgress::finish);
+      Container container;
+      for (auto& source_container : *containers) {
+        container += source_container;
+        source_container.clear();
+      }
+      tableModel->loadPoints(container);
+    }, points_stages);
+    auto loaded = loaded_sources;
+    pipeline.start([=] {
+      emit loadComplete(loaded.dbid,
+                        loaded.src || src_enabled,
+                        loaded.xml || xml_enabled,
+                        loaded.ophxml || ophxml_enabled,
+                        loaded.excel,
+                        loaded.ams);
+    }, load_token);
   });
 
   connect(compareButton, &QPushButton::clicked, this, [this] {
@@ -439,8 +605,15 @@ void MainWindow::connectSignals() {
     auto path
         = QFileDialog::getSaveFileName(this, "Save DBID", "", "*.imp");
     if (!path.isEmpty()) {
-      ThreadRunner::ThreadRunner([this, path] {
-        treeModel->saveDbid(path);
+      saveStarted();
+      auto snapshot = treeModel->dbidSnapshot();
+      ThreadRunner::run([this, path, snapshot] {
+        return treeModel->saveDbid(path, snapshot);
+      }, ThreadRunner::Priority::HIGH).then(this, [this, path](bool saved) {
+        saveFinished();
+        if (saved) {
+          emit updateStatus("DBID сохранён: " + path);
+        }
       });
     }
   });
@@ -465,6 +638,12 @@ void MainWindow::connectSignals() {
                         bool ophxml_enabled,
                         bool excel_enabled,
                         bool ams_enabled) {
+    loaded_sources = {dbid_enabled,
+                      src_enabled,
+                      xml_enabled,
+                      ophxml_enabled,
+                      excel_enabled,
+                      ams_enabled};
     for (int i = 0; i < sideLayout->count(); ++i) {
       auto widget = sideLayout->itemAt(i)->widget();
       if (widget != nullptr) {
@@ -502,7 +681,11 @@ void MainWindow::connectSignals() {
     emit updateStatus("Загрузка завершена");
   });
   connect(loader, &Loader::updateProgress,
+          loadProgress, &LoadProgress::setProgress);
+  connect(loadProgress, &LoadProgress::updateProgress,
           progressBar, &QProgressBar::setValue);
+  connect(loadProgress, &LoadProgress::updateFormat,
+          progressBar, &QProgressBar::setFormat);
   connect(loader, &Loader::updateStatus,
           statusBar, &QStatusBar::showMessage);
   connect(tableModel, &PointsTableModel::updateProgress,
@@ -522,13 +705,14 @@ void MainWindow::connectSignals() {
       return;
     }
     auto row = selection.indexes().first().row();
-    auto kks = proxyModel->data(proxyModel->index(row, 0)).toString();
+    auto source_row =
+        proxyModel->mapToSource(proxyModel->index(row, 0)).row();
     auto filter_mode =
             static_cast<PointsTableModel::FilterMode>(
                 proxyModel->getFilterMode());
-    if (tableModel->filtering.hasError(kks, filter_mode)) {
+    if (tableModel->filtering.hasError(source_row, filter_mode)) {
       textBrowser->setText(tableModel->filtering.getErrorInfo(
-                               kks, filter_mode).join('\n'));
+                               source_row, filter_mode).join('\n'));
     } else {
       textBrowser->clear();
     }
@@ -545,9 +729,14 @@ void MainWindow::connectSignals() {
     ++i;
   }
 
+  // The search runs once typing pauses
+  kksFilterTimer = new QTimer(this);
+  kksFilterTimer->setSingleShot(true);
+  kksFilterTimer->setInterval(200);
   connect(kksFilterLineEdit, &QLineEdit::textChanged,
-          this, [this](const QString& text) {
-    proxyModel->setFilterWildcard(text);
+          kksFilterTimer, qOverload<>(&QTimer::start));
+  connect(kksFilterTimer, &QTimer::timeout, this, [this]() {
+    proxyModel->setKksFilter(kksFilterLineEdit->text());
   });
 }
 
@@ -591,7 +780,7 @@ FilterInfoDialog::FilterInfoDialog(const QString& details, QWidget* parent)
 
 CharacteristicsDialog::CharacteristicsDialog(PointsTableModel* tableModel,
                                              QWidget* parent)
-    : QDialog(parent) {
+    : QDialog(parent), tableModel(tableModel) {
   setWindowTitle("Характеристика");
   setMinimumSize(100, 100);
   auto layout = new QGridLayout(this);
@@ -599,30 +788,89 @@ CharacteristicsDialog::CharacteristicsDialog(PointsTableModel* tableModel,
                               "* - любое количество любых символов\n"
                               "[abc] - один из указанных символов", this);
   layout->addWidget(infoLabel, layout->rowCount(), 0, 1, -1);
-  auto equalRadioButton = new QRadioButton("Равно", this);
-  layout->addWidget(equalRadioButton, layout->rowCount(), 0);
-  auto notEqualRadioButton = new QRadioButton("Не равно", this);
-  layout->addWidget(notEqualRadioButton, layout->rowCount() - 1, 1);
-  if (tableModel->characteristicsFilter.compare_equal) {
-    equalRadioButton->setChecked(true);
-  } else {
-    notEqualRadioButton->setChecked(true);
+  masksLayout = new QGridLayout;
+  layout->addLayout(masksLayout, layout->rowCount(), 0, 1, -1);
+  // The counts are updated once typing pauses
+  errorCountTimer = new QTimer(this);
+  errorCountTimer->setSingleShot(true);
+  errorCountTimer->setInterval(200);
+  connect(errorCountTimer, &QTimer::timeout,
+          this, &CharacteristicsDialog::updateErrorCounts);
+  for (const auto& mask : tableModel->characteristicsFilter.masks) {
+    addMask(mask);
   }
-  auto maskLineEdit = new QLineEdit(this);
-  maskLineEdit->setText(tableModel->characteristicsFilter.mask);
-  layout->addWidget(maskLineEdit, layout->rowCount(), 0, 1, -1);
+  auto addButton = new QPushButton("Добавить маску", this);
+  layout->addWidget(addButton, layout->rowCount(), 0, 1, -1);
+  connect(addButton, &QPushButton::clicked, this, [this]() {
+    addMask({});
+    errorCountTimer->start();
+  });
   auto applyButton = new QPushButton("Применить", this);
   layout->addWidget(applyButton, layout->rowCount(), 0, 1, -1);
-  connect(applyButton, &QPushButton::clicked,
-          this, [tableModel, maskLineEdit, equalRadioButton]() {
-    tableModel->characteristicsFilter.mask = maskLineEdit->text();
-    tableModel->characteristicsFilter.compare_equal =
-            equalRadioButton->isChecked();
+  connect(applyButton, &QPushButton::clicked, this, [this, tableModel]() {
+    QVector<PointsTableModel::CharacteristicsFilter::Mask> masks;
+    for (const auto& s : structure_list) {
+      masks.append({s.lineEdit->text(), s.comboBox->currentIndex() == 0});
+    }
+    auto& filter = tableModel->characteristicsFilter;
+    if (filter.masks == masks) {
+      return;
+    }
+    filter.masks = masks;
     tableModel->updateFiltering(
     {PointsTableModel::FilterMode::CHARACTERISTICS_ERRORS});
   });
 }
 
+void CharacteristicsDialog::showEvent(QShowEvent* event) {
+  QDialog::showEvent(event);
+  updateErrorCounts();
+}
+
+void CharacteristicsDialog::addMask(
+    const PointsTableModel::CharacteristicsFilter::Mask& mask) {
+  auto row = masksLayout->rowCount();
+  auto lineEdit = new QLineEdit(mask.mask, this);
+  masksLayout->addWidget(lineEdit, row, 0);
+  auto comboBox = new QComboBox(this);
+  comboBox->addItems({"Равно", "Не равно"});
+  comboBox->setCurrentIndex(mask.compare_equal ? 0 : 1);
+  masksLayout->addWidget(comboBox, row, 1);
+  auto errorCountLabel = new QLabel(this);
+  masksLayout->addWidget(errorCountLabel, row, 2);
+  auto removeButton = new QPushButton("Удалить", this);
+  masksLayout->addWidget(removeButton, row, 3);
+  structure_list.append({lineEdit, comboBox, errorCountLabel, removeButton});
+  connect(lineEdit, &QLineEdit::textChanged,
+          errorCountTimer, qOverload<>(&QTimer::start));
+  connect(comboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+          errorCountTimer, qOverload<>(&QTimer::start));
+  connect(removeButton, &QPushButton::clicked, this, [this, lineEdit]() {
+    for (int i = 0; i < structure_list.size(); ++i) {
+      const auto& s = structure_list[i];
+      if (s.lineEdit == lineEdit) {
+        s.lineEdit->deleteLater();
+        s.comboBox->deleteLater();
+        s.errorCountLabel->deleteLater();
+        s.removeButton->deleteLater();
+        structure_list.removeAt(i);
+        break;
+      }
+    }
+  });
+}
+
+void CharacteristicsDialog::updateErrorCounts() {
+  if (!isVisible()) {
+    return;
+  }
+  for (const auto& s : structure_list) {
+    auto count = tableModel->characteristicsErrorCount(
+      {s.lineEdit->text(), s.comboBox->currentIndex() == 0});
+    s.errorCountLabel->setText("Ошибок: " + QString::number(count));
+  }
+}
+
 AncillaryOrderDialog::AncillaryOrderDialog(PointsTableModel* tableModel,
                                            QWidget* parent)
     : QDialog(parent) {
@@ -648,10 +896,15 @@ AncillaryOrderDialog::AncillaryOrderDialog(PointsTableModel* tableModel,
   auto applyButton = new QPushButton("Применить", this);
   layout->addWidget(applyButton, layout->rowCount(), 0, 1, -1);
   connect(applyButton, &QPushButton::clicked, this, [this, tableModel]() {
+    auto order = tableModel->ancillaryFilter.order;
     for (const auto& s : structure_list) {
-      tableModel->ancillaryFilter.order[s.parameter] =
+      order[s.parameter] =
       {s.checkBox->isChecked(), anc_list[s.comboBox->currentIndex()]};
     }
+    if (order == tableModel->ancillaryFilter.order) {
+      return;
+    }
+    tableModel->ancillaryFilter.order = order;
     tableModel->updateFiltering(
     {PointsTableModel::FilterMode::ANCILLARY_ERRORS});
   });
@@ -684,11 +937,15 @@ AlarmsDialog::AlarmsDialog(PointsTableModel* tableModel,
   auto applyButton = new QPushButton("Применить", this);
   layout->addWidget(applyButton, layout->rowCount(), 0, 1, -1);
   connect(applyButton, &QPushButton::clicked, this, [this, tableModel]() {
-    auto& priority = tableModel->alarmsFilter.priority;
+    auto priority = tableModel->alarmsFilter.priority;
     for (const auto& s : structure_list) {
       priority[s.parameter] =
       {s.checkBox->isChecked(), s.comboBox->currentText().toInt()};
     }
+    if (priority == tableModel->alarmsFilter.priority) {
+      return;
+    }
+    tableModel->alarmsFilter.priority = priority;
     tableModel->updateFiltering(
     {PointsTableModel::FilterMode::LIMITS_PRIORITY_ERRORS});
   });
@@ -757,13 +1014,21 @@ ExportExcelDialog::ExportExcelDialog(MainWindow *parent)
   });
 
   connect(applyButton, &QPushButton::clicked, this, [this, pathLineEdit] {
-    ThreadRunner::ThreadRunner([this, pathLineEdit]() {
-      exportExcel(pathLineEdit->text());
+    auto path = pathLineEdit->text();
+    auto mainWindow = qobject_cast<MainWindow*>(parent());
+    mainWindow->saveStarted();
+    ThreadRunner::run([this, path]() {
+      return exportExcel(path);
+    }, ThreadRunner::Priority::HIGH).then(this, [=](bool saved) {
+      mainWindow->saveFinished();
+      emit updateStatus(saved
+                        ? "Сохранение Excel-файла. Подождите... Завершено"
+                        : "Не удалось сохранить Excel-файл: " + path);
     });
   });
 }
 
-void ExportExcelDialog::exportExcel(const QString& file_name) {
+bool ExportExcelDialog::exportExcel(const QString& file_name) {
   Q_ASSERT_X(!file_name.isEmpty(), Q_FUNC_INFO, "file_name is empty");
   auto mainWindow = qobject_cast<MainWindow*>(parent());
   emit updateProgress(0);
@@ -780,6 +1045,8 @@ void ExportExcelDialog::exportExcel(const QString& file_name) {
   gray_background_format.setFillPattern(QXlsx::Format::FillPattern::PatternSolid);
   gray_background_format.setPatternBackgroundColor(QColor(160, 160, 164, 255));
   auto model = new PointsSortFilterProxyModel(mainWindow->proxyModel);
+  auto source_model = static_cast<PointsTableModel*>(model->sourceModel());
+  const auto& point_store = source_model->pointStore();
   QList<int> modes;
   if (filterMode == FilterMode::CURRENT) {
     for (const auto& radioButton : mainWindow->filtersButtons) {
@@ -816,24 +1083,31 @@ void ExportExcelDialog::exportExcel(const QString& file_name) {
       }
     }
 
+    // Values and colors are read from the point store directly, the proxy
+    // only maps the rows and columns
     int row_count = model->rowCount();
     int column_count = model->columnCount();
     for (int row = 0; row < row_count; row++) {
       emit updateProgress(100 * row / (row_count - 1));
       for (int col = 0; col < column_count; col++) {
         QXlsx::CellReference cell(row + 2, col + 1);
-        xlsx.write(cell, model->data(model->index(row, col)));
-        if (model->data(model->index(row, col),
-                        Qt::BackgroundColorRole) == QColor(Qt::red)) {
-          xlsx.write(cell, xlsx.cellAt(cell)->value(), red_background_format);
-        } else if (model->data(model->index(row, col),
-                               Qt::BackgroundColorRole) == QColor(Qt::gray)) {
-          xlsx.write(cell, xlsx.cellAt(cell)->value(), gray_background_format);
+        auto source_index = model->mapToSource(model->index(row, col));
+        const auto& value = point_store.value(
+              source_index.row(),
+              PointInfo::point_parameters[source_index.column()]);
+        auto color = source_model->getCellColor(source_index.row(),
+                                                source_index.column(),
+                                                mode);
+        if (color == QColor(Qt::red)) {
+          xlsx.write(cell, value, red_background_format);
+        } else if (color == QColor(Qt::gray)) {
+          xlsx.write(cell, value, gray_background_format);
+        } else {
+          xlsx.write(cell, value);
         }
       }
     }
   }
   emit updateStatus("Сохранение Excel-файла. Подождите...");
-  xlsx.saveAs(file_name);
-  emit updateStatus("Сохранение Excel-файла. Подождите... Завершено");
+  return xlsx.saveAs(file_name);
 }
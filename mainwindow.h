@@ -22,6 +22,7 @@
 #include <QRadioButton>
 #include <QDialog>
 #include <QComboBox>
+#include <QTimer>
 
 #include "tableview.h"
 #include "treemodel.h"
@@ -31,8 +32,10 @@
 #include "excelpointsmodel.h"
 #include "comparemodel.h"
 #include "amsmodel.h"
+#include "threadrunner.h"
 
 class Loader;
+class LoadProgress;
 class ExportExcelDialog;
 
 class MainWindow : public QMainWindow {
@@ -40,6 +43,8 @@ class MainWindow : public QMainWindow {
 
 public:
   explicit MainWindow(QWidget* parent = nullptr);
+  // Cancels the load and waits for the background work using the models
+  ~MainWindow() override;
 
   void setupModels();
   void setupUi();
@@ -66,6 +71,7 @@ protected:
 private:
 
   Loader* loader;
+  LoadProgress* loadProgress;
 
   PointsTableModel* tableModel;
   TreeModel* treeModel;
@@ -124,6 +130,7 @@ private:
   QPushButton* amsPathButton;
   QPushButton* backupPathButton;
   QPushButton* loadButton;
+  QPushButton* reloadButton;
 
   QPushButton *compareButton;
   QPushButton *soeButton;
@@ -132,6 +139,7 @@ private:
   QGridLayout* filtersGroupBoxLayout;
   QList<QRadioButton*> filtersButtons;
   QLineEdit* kksFilterLineEdit;
+  QTimer* kksFilterTimer;
 
   QMap<PointsTableModel::FilterMode, QDialog*> filter_option_dialogs_;
   QMap<PointsTableModel::FilterMode, QDialog*> filter_details_dialogs_;
@@ -143,6 +151,25 @@ private:
   ExportExcelDialog *exportExcelDialog;
 
   bool init = true;
+
+  // Cancels the stages of the running load
+  ThreadRunner::CancellationToken load_token;
+
+  // The saves read the models and the string pool in the background, a
+  // load which clears them is not started until they are done
+  void saveStarted();
+  void saveFinished();
+  int running_saves = 0;
+
+  // Sources of the shown data, a reload of some sources keeps the others
+  struct LoadedSources {
+    bool dbid = false;
+    bool src = false;
+    bool xml = false;
+    bool ophxml = false;
+    bool excel = false;
+    bool ams = false;
+  } loaded_sources;
 };
 
 class FilterInfoDialog : public QDialog {
@@ -158,6 +185,22 @@ class CharacteristicsDialog : public QDialog {
   Q_OBJECT
 public:
   CharacteristicsDialog(PointsTableModel* tableModel, QWidget* parent = nullptr);
+protected:
+  void showEvent(QShowEvent* event) override;
+private:
+  void addMask(const PointsTableModel::CharacteristicsFilter::Mask& mask);
+  // Shows next to every mask how many points it reports
+  void updateErrorCounts();
+  PointsTableModel* tableModel;
+  QGridLayout* masksLayout;
+  QTimer* errorCountTimer;
+  struct structure {
+    QLineEdit* lineEdit;
+    QComboBox* comboBox;
+    QLabel* errorCountLabel;
+    QPushButton* removeButton;
+  };
+  QList<structure> structure_list;
 };
 
 class AncillaryOrderDialog : public QDialog {
@@ -202,7 +245,8 @@ public:
   QList<QCheckBox*> filterButtons;
   enum class FilterMode {CURRENT, MULTI} filterMode;
 
-  void exportExcel(const QString& file_name);
+  // false if the file could not be written
+  bool exportExcel(const QString& file_name);
 
 signals:
   void updateStatus(const QString& status, int timeout = 0);
@@ -0,0 +1,111 @@
+#include "mappedfile.h"
+
+#include <cstring>
+#include <limits>
+
+#include <QVector>
+#include <QtEndian>
+
+namespace {
+
+  // Code units of a UTF-16 or UTF-32 file in the host byte order
+  template<typename T>
+  QVector<T> codeUnits(const char* data, qint64 size, bool big_endian) {
+    QVector<T> units(static_cast<int>(size / sizeof(T)));
+    for (int i = 0; i < units.size(); ++i) {
+      auto unit = data + i * sizeof(T);
+      units[i] = big_endian ? qFromBigEndian<T>(unit)
+                            : qFromLittleEndian<T>(unit);
+    }
+    return units;
+  }
+
+}
+
+MappedFile::MappedFile(const QString& file_path) : file_(file_path) {
+  if (!file_.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  size_ = file_.size();
+  if (size_ > 0) {
+    data_ = reinterpret_cast<const char*>(file_.map(0, size_));
+    if (data_ == nullptr) {
+      buffer_ = file_.readAll();
+      data_ = buffer_.constData();
+      size_ = buffer_.size();
+    }
+  }
+
+  const struct {
+    const char* bytes;
+    int size;
+    int unit_size;
+    bool big_endian;
+  } boms[] = {
+    {"\xEF\xBB\xBF", 3, 1, false},
+    {"\xFF\xFE\x00\x00", 4, 4, false},
+    {"\x00\x00\xFE\xFF", 4, 4, true},
+    {"\xFF\xFE", 2, 2, false},
+    {"\xFE\xFF", 2, 2, true}
+  };
+  for (const auto& bom : boms) {
+    if (size_ < bom.size || std::memcmp(data_, bom.bytes, bom.size) != 0) {
+      continue;
+    }
+    encoding_ = Encoding::UTF8;
+    data_ += bom.size;
+    size_ -= bom.size;
+    // The scanners look for ASCII bytes, UTF-16 and UTF-32 files are
+    // converted to UTF-8 the way QTextStream would have decoded them. A file
+    // too big for the scanners is left as it is, they skip it.
+    if (bom.unit_size > 1
+        && size_ <= std::numeric_limits<int>::max()) {
+      QString text;
+      if (bom.unit_size == 2) {
+        auto units = codeUnits<quint16>(data_, size_, bom.big_endian);
+        text = QString::fromUtf16(units.constData(), units.size());
+      } else {
+        auto units = codeUnits<quint32>(data_, size_, bom.big_endian);
+        text = QString::fromUcs4(units.constData(), units.size());
+      }
+      buffer_ = text.toUtf8();
+      data_ = buffer_.constData();
+      size_ = buffer_.size();
+    }
+    break;
+  }
+}
+
+bool MappedFile::isOpen() const {
+  return file_.isOpen();
+}
+
+const char* MappedFile::data() const {
+  return data_;
+}
+
+qint64 MappedFile::size() const {
+  return size_;
+}
+
+MappedFile::Encoding MappedFile::encoding() const {
+  return encoding_;
+}
+
+QString MappedFile::decode(const char* data, int size) const {
+  return decode(encoding_, data, size);
+}
+
+QString MappedFile::decode(Encoding encoding, const char* data, int size) {
+  if (encoding == Encoding::UTF8) {
+    return QString::fromUtf8(data, size);
+  }
+  return QString::fromLocal8Bit(data, size);
+}
+
+QByteArray MappedFile::encode(Encoding encoding, const QString& string) {
+  if (encoding == Encoding::UTF8) {
+    return string.toUtf8();
+  }
+  return string.toLocal8Bit();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+// Read-only byte view of a whole file. The file is memory mapped when the
+// platform allows it and read into a buffer otherwise, in both cases without
+// decoding. A UTF-8 byte order mark is stripped from the view and selects
+// the encoding, the local 8-bit codec is assumed otherwise, the same way
+// QTextStream reads the files by default. A file with a UTF-16 or UTF-32
+// byte order mark is converted into a UTF-8 buffer, the view and the files
+// saved from it are UTF-8.
+class MappedFile {
+public:
+  enum class Encoding {
+    LOCAL_8BIT, UTF8
+  };
+
+  explicit MappedFile(const QString& file_path);
+
+  bool isOpen() const;
+  const char* data() const;
+  qint64 size() const;
+  Encoding encoding() const;
+
+  // Decodes bytes taken from this file
+  QString decode(const char* data, int size) const;
+
+  // Conversions for the data kept after the file is closed
+  static QString decode(Encoding encoding, const char* data, int size);
+  static QByteArray encode(Encoding encoding, const QString& string);
+
+private:
+  Q_DISABLE_COPY(MappedFile)
+
+  QFile file_;
+  QByteArray buffer_;
+  const char* data_ = "";
+  qint64 size_ = 0;
+  Encoding encoding_ = Encoding::LOCAL_8BIT;
+};
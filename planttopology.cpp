@@ -0,0 +1,171 @@
+#include "planttopology.h"
+
+#include "point.h"
+
+namespace {
+
+  // DBIDs nested differently are searched like they used to be: the first
+  // object named UNIT... of type Unit... in document order and its children
+  // of type Drop...
+  QVector<DbidTree::Node> dropItems(const DbidTree& dbid_tree) {
+    auto drop_items =
+        dbid_tree.select(DbidTree::root, "System/Network/Unit/Drop");
+    if (!drop_items.isEmpty()) {
+      return drop_items;
+    }
+    QVector<DbidTree::Node> stack = {DbidTree::root};
+    while (!stack.isEmpty()) {
+      auto node = stack.takeLast();
+      if (dbid_tree.parameter(node).startsWith("UNIT")
+          && dbid_tree.value(node).startsWith("Unit")) {
+        for (int i = 0; i < dbid_tree.childCount(node); ++i) {
+          auto child = dbid_tree.child(node, i);
+          if (dbid_tree.value(child).startsWith("Drop")) {
+            drop_items.append(child);
+          }
+        }
+        break;
+      }
+      for (int i = dbid_tree.childCount(node) - 1; i >= 0; --i) {
+        stack.append(dbid_tree.child(node, i));
+      }
+    }
+    return drop_items;
+  }
+
+}
+
+PlantTopology PlantTopology::build(const DbidTree& dbid_tree) {
+  auto& string_pool = StringPool::instance();
+  PlantTopology topology;
+  auto digital_point = PointInfo::toString(PointInfo::Type::DigitalPoint);
+  // The tree is walked by the child indexes, every node below a drop is
+  // visited at most once
+  for (auto drop_item : dropItems(dbid_tree)) {
+    Id drop_id = topology.drops_.size();
+    Drop drop;
+    drop.name = string_pool.intern(dbid_tree.parameter(drop_item));
+    drop.node = drop_item;
+    auto drop_number = dbid_tree.parameter(drop_item)
+        .mid(QString("DROP").length(), 2);
+
+    for (auto io_device_item
+         : dbid_tree.childrenOfType(drop_item, "IoDevice")) {
+      if (!dbid_tree.parameter(io_device_item)
+          .startsWith("I/O Device 0 IOIC")) {
+        continue;
+      }
+      for (auto io_interface_item
+           : dbid_tree.childrenOfType(io_device_item, "IoDevice")) {
+        auto io_interface_number = dbid_tree.parameter(io_interface_item)
+            .mid(QString("I/O Interface ").length(), 1);
+        if (io_interface_number != "1" && io_interface_number != "2") {
+          continue;
+        }
+        for (auto module_item
+             : dbid_tree.select(io_interface_item, "Branch/RSlot/RModule")) {
+          auto slot_item = dbid_tree.parent(module_item);
+          auto branch_item = dbid_tree.parent(slot_item);
+          auto branch_number = dbid_tree.parameter(branch_item)
+              .mid(QString("Branch ").length(), 1);
+          auto slot_number = dbid_tree.parameter(slot_item)
+              .mid(QString("Slot ").length(), 1);
+          auto module_point_name_item =
+              dbid_tree.findChild(module_item, "POINT_NAME");
+          if (module_point_name_item != DbidTree::null) {
+            if (dbid_tree.value(module_point_name_item)
+                    != QString("MP_") + drop_number + "_"
+                       + io_interface_number + "_" + branch_number
+                       + "_" + slot_number) {
+              qFatal(qPrintable(dbid_tree.value(module_point_name_item)
+                                + " does not refer to real location"));
+            }
+          } else {
+            qFatal(qPrintable(dbid_tree.parameter(module_item)
+                              + " does not have POINT_NAME"));
+          }
+          Module module;
+          module.drop = drop_id;
+          module.io_interface = io_interface_number.toInt();
+          module.branch = branch_number.toInt();
+          module.slot = slot_number.toInt();
+          module.io_location = string_pool.intern(
+                io_interface_number + "." + branch_number
+                + "." + slot_number);
+          module.node = module_item;
+          auto event_tagging_enable_item =
+              dbid_tree.findChild(module_item, "EVENT_TAGGING_ENABLE");
+          module.soe_input = event_tagging_enable_item != DbidTree::null
+              ? string_pool.intern(dbid_tree.value(event_tagging_enable_item))
+              : StringPool::invalid_id;
+          Id module_id = topology.modules_.size();
+          topology.modules_by_location_.insert(
+                moduleKey(drop_id, module.io_location), module_id);
+          topology.modules_.append(module);
+          drop.modules.append(module_id);
+        }
+      }
+    }
+
+    for (auto control_task_item
+         : dbid_tree.select(drop_item, "ConfigController/ConfigDPUCtrlTask")) {
+      auto control_task_number = dbid_tree.parameter(control_task_item)
+          .mid(QString("Control Task ").length(), 1);
+      auto periodtime_item =
+          dbid_tree.findChild(control_task_item, "periodtime");
+      if (periodtime_item != DbidTree::null) {
+        drop.task_periods.insert(
+              string_pool.intern(control_task_number),
+              string_pool.intern(dbid_tree.value(periodtime_item)));
+      }
+    }
+
+    drop.digital_points = dbid_tree.childrenOfType(drop_item, digital_point);
+
+    topology.drops_by_name_.insert(drop.name, drop_id);
+    topology.drops_.append(drop);
+  }
+  return topology;
+}
+
+int PlantTopology::dropCount() const {
+  return drops_.size();
+}
+
+const PlantTopology::Drop& PlantTopology::drop(Id drop) const {
+  return drops_[drop];
+}
+
+int PlantTopology::moduleCount() const {
+  return modules_.size();
+}
+
+const PlantTopology::Module& PlantTopology::module(Id module) const {
+  return modules_[module];
+}
+
+PlantTopology::Id PlantTopology::findDrop(StringPool::Id name) const {
+  return drops_by_name_.value(name, null);
+}
+
+PlantTopology::Id PlantTopology::findModule(Id drop,
+                                            StringPool::Id io_location) const {
+  if (drop == null) {
+    return null;
+  }
+  return modules_by_location_.value(moduleKey(drop, io_location), null);
+}
+
+const QString& PlantTopology::taskPeriod(Id drop, StringPool::Id task) const {
+  auto& string_pool = StringPool::instance();
+  if (drop == null) {
+    return string_pool.string(StringPool::null_id);
+  }
+  return string_pool.string(
+        drops_[drop].task_periods.value(task, StringPool::null_id));
+}
+
+quint64 PlantTopology::moduleKey(Id drop, StringPool::Id io_location) {
+  return (static_cast<quint64>(static_cast<quint32>(drop)) << 32)
+      | static_cast<quint32>(io_location);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "dbidtree.h"
+#include "stringpool.h"
+
+// Drops, I/O modules and control tasks of the plant, built once from the
+// DBID. Drops and modules are numbered, names, I/O locations and task
+// numbers are looked up by their interned ids, so the point checks and the
+// SOE recalculation never walk the tree or string-keyed maps.
+class PlantTopology {
+public:
+  using Id = int;
+  static constexpr Id null = -1;
+
+  struct Module {
+    Id drop;
+    int io_interface;
+    int branch;
+    int slot;
+    // "interface.branch.slot", the IO_LOCATION of the points of the module
+    StringPool::Id io_location;
+    DbidTree::Node node;
+    // EVENT_TAGGING_ENABLE, invalid_id if the module does not have it
+    StringPool::Id soe_input;
+  };
+
+  struct Drop {
+    StringPool::Id name;
+    DbidTree::Node node;
+    QVector<Id> modules;
+    // periodtime by control task number
+    QHash<StringPool::Id, StringPool::Id> task_periods;
+    QVector<DbidTree::Node> digital_points;
+  };
+
+  static PlantTopology build(const DbidTree& dbid_tree);
+
+  int dropCount() const;
+  const Drop& drop(Id drop) const;
+  int moduleCount() const;
+  const Module& module(Id module) const;
+
+  Id findDrop(StringPool::Id name) const;
+  Id findModule(Id drop, StringPool::Id io_location) const;
+
+  // A null string if the drop or the task is unknown
+  const QString& taskPeriod(Id drop, StringPool::Id task) const;
+
+private:
+  static quint64 moduleKey(Id drop, StringPool::Id io_location);
+
+  QVector<Drop> drops_;
+  QVector<Module> modules_;
+  QHash<StringPool::Id, Id> drops_by_name_;
+  QHash<quint64, Id> modules_by_location_;
+};
@@ -4,6 +4,8 @@
 #include <QMetaEnum>
 #include <QString>
 
+#include "pointstore.h"
+
 QString PointInfo::toString(const PointInfo::Type& type) {
   return QVariant::fromValue(type).toString();
 }
@@ -23,7 +25,7 @@ const QVector<PointInfo::Type> PointInfo::point_types = []() {
 }();
 
 QString PointInfo::toString(const PointInfo::Parameter& parameter) {
-  return QVariant::fromValue(parameter).toString();
+  return point_parameter_names[static_cast<int>(parameter)];
 }
 
 PointInfo::Parameter PointInfo::parameterFromString(const QString& parameter) {
@@ -40,90 +42,35 @@ const QVector<PointInfo::Parameter> PointInfo::point_parameters = []() {
   return result;
 }();
 
-Point::Point(QHash<PointInfo::Parameter, QString> parameters)
-    : parameters_(parameters) {
-  const auto& appear_in_file = parameters[PointInfo::Parameter::APPEAR_IN_FILES];
-  if (!appear_in_file.isEmpty()) {
-    addToAppearInFiles(appear_in_file);
+const QVector<QString> PointInfo::point_parameter_names = []() {
+  auto e = QMetaEnum::fromType<PointInfo::Parameter>();
+  QVector<QString> result(e.keyCount());
+  for (int i = 0; i < e.keyCount(); ++i) {
+    result[e.value(i)] = e.key(i);
   }
-}
-
-const bool& Point::isInDBID() const {
-  return is_in_dbid;
-}
-
-const bool& Point::isInSRC() const {
-  return is_in_src;
-}
+  return result;
+}();
 
-const bool& Point::isInXML() const {
-  return is_in_xml;
-}
+Point::Point(const PointStore& store, int row)
+    : store_(store), row_(row) {}
 
-const bool& Point::isInOPHXML() const {
-  return is_in_ophxml;
+bool Point::isInDBID() const {
+  return store_.isInDBID(row_);
 }
 
-const QString Point::operator[](const PointInfo::Parameter& parameter) const {
-  return parameters_[parameter];
+bool Point::isInSRC() const {
+  return store_.isInSRC(row_);
 }
 
-QString& Point::operator[](const PointInfo::Parameter& parameter) {
-  return parameters_[parameter];
+bool Point::isInXML() const {
+  return store_.isInXML(row_);
 }
 
-void Point::addParameters(QHash<PointInfo::Parameter, QString> parameters) {
-  auto kks = parameters[PointInfo::Parameter::KKS];
-  if (!kks.isEmpty() && parameters_[PointInfo::Parameter::KKS] == kks) {
-    for (auto it = parameters.keyValueBegin();
-         it != parameters.keyValueEnd(); ++it) {
-      auto parameter = (*it).first;
-      if (parameter != PointInfo::Parameter::KKS) {
-        auto value = (*it).second;
-        if (parameter == PointInfo::Parameter::APPEAR_IN_FILES) {
-          addToAppearInFiles(value);
-        } else {
-          parameters_[parameter] = value;
-        }
-      }
-
-    }
-  }
+bool Point::isInOPHXML() const {
+  return store_.isInOPHXML(row_);
 }
 
-
-void Point::addToAppearInFiles(const QString& appear_in_file) {
-  if (!appear_in_files_.contains(appear_in_file)) {
-    if (!is_in_dbid && appear_in_file == "DBID.imp") {
-      is_in_dbid = true;
-    } else if (!is_in_src
-               && QStringRef(&appear_in_file, appear_in_file.length() - 3, 3)
-               == "src") {
-      is_in_src = true;
-    } else if (!is_in_xml
-               && QStringRef(&appear_in_file, appear_in_file.length() - 3, 3)
-               == "xml") {
-      is_in_xml = true;
-    } else if (!is_in_ophxml && appear_in_file == "HistorianConfig.xml") {
-      is_in_ophxml = true;
-    }
-
-    appear_in_files_.append(appear_in_file);
-    appear_in_files_.sort();
-    auto& file_list = parameters_[PointInfo::Parameter::APPEAR_IN_FILES];
-    if (is_in_dbid) {
-      file_list = "DBID.imp";
-    } else {
-      file_list = "";
-    }
-    for (const auto& file : appear_in_files_) {
-      if (file != "DBID.imp") {
-        if (!file_list.isEmpty()) {
-          file_list += ", " + file;
-        } else {
-          file_list = file;
-        }
-      }
-    }
-  }
+const QString& Point::operator[](
+        const PointInfo::Parameter& parameter) const {
+  return store_.value(row_, parameter);
 }
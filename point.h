@@ -81,31 +81,32 @@ namespace PointInfo {
   QString toString(const Parameter& parameter);
   Parameter parameterFromString(const QString& parameter);
   extern const QVector<Parameter> point_parameters;
+  // Names of the parameters indexed by their values
+  extern const QVector<QString> point_parameter_names;
 
   inline uint qHash(const Parameter& parameter, uint seed = 0) {
       return ::qHash(static_cast<uint>(parameter), seed);
   };
 };
 
+class PointStore;
+
+// Read-only view of one row of a PointStore
 class Point {
 public:
 
-  Point(QHash<PointInfo::Parameter, QString> parameters);
+  Point(const PointStore& store, int row);
 
 //    const static QVector<QString> dbid_parameters_names;
 //    const static QVector<QString> additional_parameters_names;
 //    const static QVector<QString> parameters_names;
 
-  const bool& isInDBID() const;
-  const bool& isInSRC() const;
-  const bool& isInXML() const;
-  const bool& isInOPHXML() const;
-
-  const QString operator[](const PointInfo::Parameter& parameter) const;
-  QString& operator[](const PointInfo::Parameter& parameter);
+  bool isInDBID() const;
+  bool isInSRC() const;
+  bool isInXML() const;
+  bool isInOPHXML() const;
 
-  void addParameters(QHash<PointInfo::Parameter, QString> parameters);
-  void addToAppearInFiles(const QString& appear_in_file);
+  const QString& operator[](const PointInfo::Parameter& parameter) const;
 
 //  bool hasParameter(const QString& parameter) const;
 
@@ -116,11 +117,6 @@ public:
 
 private:
 
-  QHash<PointInfo::Parameter, QString> parameters_;
-
-  QStringList appear_in_files_;
-  bool is_in_dbid = false;
-  bool is_in_src = false;
-  bool is_in_xml = false;
-  bool is_in_ophxml = false;
+  const PointStore& store_;
+  int row_;
 };
@@ -1,5 +1,7 @@
 #include "pointssortfilterproxymodel.h"
 
+#include <algorithm>
+
 #include <QDebug>
 
 #include "pointstablemodel.h"
@@ -13,10 +15,26 @@ PointsSortFilterProxyModel::PointsSortFilterProxyModel(
         PointsSortFilterProxyModel* model) : QSortFilterProxyModel() {
   setSourceModel(model->sourceModel());
   sort_columns = model->sort_columns;
-  setFilterRegExp(model->filterRegExp());
+  kks_filter_ = model->kks_filter_;
+  kks_matches_ = model->kks_matches_;
   sort(0);
 }
 
+void PointsSortFilterProxyModel::setSourceModel(
+        QAbstractItemModel* source_model) {
+  sort_ranks.clear();
+  QSortFilterProxyModel::setSourceModel(source_model);
+  auto clear_ranks = [this] {
+    sort_ranks.clear();
+    kks_matches_.clear();
+  };
+  connect(source_model, &QAbstractItemModel::modelAboutToBeReset,
+          this, clear_ranks);
+  connect(source_model, &QAbstractItemModel::dataChanged, this, clear_ranks);
+  connect(source_model, &QAbstractItemModel::rowsInserted, this, clear_ranks);
+  connect(source_model, &QAbstractItemModel::rowsRemoved, this, clear_ranks);
+}
+
 QVariant PointsSortFilterProxyModel::data(const QModelIndex& index,
                                           int role) const {
   if (role == Qt::BackgroundColorRole) {
@@ -39,17 +57,14 @@ bool PointsSortFilterProxyModel::filterAcceptsRow(
         int source_row,
         [[maybe_unused]] const QModelIndex& source_parent) const {
   bool kks_filter = true;
-  if (!filterRegExp().isEmpty()) {
-    auto model = sourceModel();
-    auto kks = model->data(model->index(source_row, 0)).toString();
-    kks_filter = filterRegExp().exactMatch(kks);
+  if (!kks_filter_.isEmpty()) {
+    kks_filter = kksMatches().testBit(source_row);
   }
   if (kks_filter) {
     if (mode_ != 0) {
       auto model = static_cast<PointsTableModel*>(sourceModel());
       return model->filtering.hasError(
-                  model->data(model->index(source_row, 0)).toString(),
-                  PointsTableModel::filters[mode_].mode);
+                  source_row, PointsTableModel::filters[mode_].mode);
     } else {
       return true;
     }
@@ -88,8 +103,6 @@ int PointsSortFilterProxyModel::getFilterMode() const {
 }
 
 void PointsSortFilterProxyModel::setFilterMode(const int& mode) {
-  auto filter_wildcard = filterRegExp();
-  setFilterWildcard("");
   mode_ = mode;
   if (mode == 5) {
     multiSort({
@@ -103,7 +116,42 @@ void PointsSortFilterProxyModel::setFilterMode(const int& mode) {
   }
   invalidateFilter();
   emit filterChanged();
-  setFilterWildcard(filter_wildcard.pattern());
+}
+
+const QString& PointsSortFilterProxyModel::kksFilter() const {
+  return kks_filter_;
+}
+
+void PointsSortFilterProxyModel::setKksFilter(const QString& pattern) {
+  if (pattern == kks_filter_) {
+    return;
+  }
+  // Typing after a trailing star only narrows the result, so the rows
+  // matched so far are enough to check
+  auto refines = !kks_matches_.isEmpty()
+      && kks_filter_.endsWith('*')
+      && pattern.startsWith(kks_filter_.left(kks_filter_.size() - 1));
+  kks_filter_ = pattern;
+  if (pattern.isEmpty()) {
+    kks_matches_.clear();
+  } else {
+    auto model = static_cast<PointsTableModel*>(sourceModel());
+    auto previous_matches = kks_matches_;
+    kks_matches_ = model->kksIndex().find(
+          model->pointStore(),
+          WildcardMask(pattern),
+          refines ? &previous_matches : nullptr);
+  }
+  invalidateFilter();
+}
+
+const QBitArray& PointsSortFilterProxyModel::kksMatches() const {
+  auto model = static_cast<PointsTableModel*>(sourceModel());
+  const auto& store = model->pointStore();
+  if (kks_matches_.size() != store.size()) {
+    kks_matches_ = model->kksIndex().find(store, WildcardMask(kks_filter_));
+  }
+  return kks_matches_;
 }
 
 void PointsSortFilterProxyModel::multiSort(const QList<int>& columns) {
@@ -113,26 +161,60 @@ void PointsSortFilterProxyModel::multiSort(const QList<int>& columns) {
 
 bool PointsSortFilterProxyModel::lessThan(
         const QModelIndex& source_left,const QModelIndex& source_right) const {
+  auto compare = [this, &source_left, &source_right](int column) {
+    const auto& ranks = sortRanks(column);
+    return ranks[source_left.row()] - ranks[source_right.row()];
+  };
   if (sort_columns.isEmpty()) {
-    return QSortFilterProxyModel::lessThan(source_left, source_right);
+    return compare(source_left.column()) < 0;
   } else {
     for (const auto& column : sort_columns) {
-
-      auto index_left = sourceModel()->index(source_left.row(), column);
-      auto index_right = sourceModel()->index(source_right.row(), column);
-
-      if (sourceModel()->data(index_left).toString()
-              < sourceModel()->data(index_right).toString()) {
-        return true;
-      } else if (sourceModel()->data(index_left).toString()
-                 > sourceModel()->data(index_right).toString()) {
-        return false;
+      auto result = compare(column);
+      if (result != 0) {
+        return result < 0;
       }
     }
     return false;
   }
 }
 
+const QVector<int>& PointsSortFilterProxyModel::sortRanks(int column) const {
+  auto model = static_cast<PointsTableModel*>(sourceModel());
+  const auto& store = model->pointStore();
+  auto it = sort_ranks.find(column);
+  if (it != sort_ranks.end() && it->size() == store.size()) {
+    return *it;
+  }
+  // Equal strings are interned to the same id, so only the distinct values
+  // are sorted. A null and an empty string are equal for sorting.
+  auto parameter = PointInfo::point_parameters[column];
+  QVector<StringPool::Id> ids(store.size());
+  for (int row = 0; row < store.size(); ++row) {
+    ids[row] = store.valueId(row, parameter);
+  }
+  auto values = ids;
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  std::sort(values.begin(), values.end(),
+            [&store](StringPool::Id left, StringPool::Id right) {
+    return store.string(left) < store.string(right);
+  });
+  QHash<StringPool::Id, int> rank_by_id;
+  rank_by_id.reserve(values.size());
+  int rank = 0;
+  for (int i = 0; i < values.size(); ++i) {
+    if (i > 0 && store.string(values[i - 1]) != store.string(values[i])) {
+      ++rank;
+    }
+    rank_by_id.insert(values[i], rank);
+  }
+  QVector<int> ranks(ids.size());
+  for (int row = 0; row < ids.size(); ++row) {
+    ranks[row] = rank_by_id[ids[row]];
+  }
+  return *sort_ranks.insert(column, ranks);
+}
+
 int PointsSortFilterProxyModel::parameterToColumnIndex(
         PointInfo::Parameter parameter) {
   return PointInfo::point_parameters.indexOf(parameter);
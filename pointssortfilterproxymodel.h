@@ -2,6 +2,10 @@
 
 #include <QSortFilterProxyModel>
 
+#include <QBitArray>
+#include <QHash>
+#include <QVector>
+
 #include <QDebug>
 
 #include "point.h"
@@ -16,8 +20,12 @@ public:
   QVariant headerData(int section,
                       Qt::Orientation orientation,
                       int role) const override;
+  void setSourceModel(QAbstractItemModel* source_model) override;
   int getFilterMode() const;
   void setFilterMode(const int& mode);
+  // KKS mask in the wildcard syntax, an empty mask shows all points
+  const QString& kksFilter() const;
+  void setKksFilter(const QString& pattern);
   void multiSort(const QList<int>& columns);
 
   void invalidate() {
@@ -41,6 +49,18 @@ private:
   int mode_ = 0;
   QList<int> sort_columns;
 
+  // Source rows matching the KKS mask, found with the KKS index of the
+  // model. Cleared when the data changes and found again on the next use.
+  const QBitArray& kksMatches() const;
+  QString kks_filter_;
+  mutable QBitArray kks_matches_;
+
+  // Rank of the value of every source row in a column, equal values share
+  // a rank. lessThan compares the ranks instead of the strings, they are
+  // built on the first comparison after the data has changed.
+  const QVector<int>& sortRanks(int column) const;
+  mutable QHash<int, QVector<int>> sort_ranks;
+
   int parameterToColumnIndex(PointInfo::Parameter parameter);
 };
 
@@ -1,16 +1,46 @@
 #include "pointstablemodel.h"
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 
+#include <QAtomicInt>
+#include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonObject>
+#include <QMetaEnum>
 #include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+#include <QtAlgorithms>
 
 #include <QDebug>
 
+#include "globalsettings.h"
+#include "threadrunner.h"
+
 using P = PointInfo::Parameter;
 
 PointsTableModel::PointsTableModel(QObject* parent)
-    : QAbstractTableModel(parent) {}
+    : QAbstractTableModel(parent),
+      plant_topology(QSharedPointer<PlantTopology>::create()) {
+  custom_filter_rules = customFilterRules();
+  if (global_settings["FilterThreadCount"].isDouble()) {
+    filter_thread_count = global_settings["FilterThreadCount"].toInt();
+  }
+}
+
+const PointStore& PointsTableModel::pointStore() const {
+  return point_store;
+}
+
+const KksIndex& PointsTableModel::kksIndex() const {
+  return kks_index;
+}
+
+const QStringList& PointsTableModel::invalidFilterRules() const {
+  return invalid_filter_rules;
+}
 
 const QList<PointsTableModel::FilterInfo> PointsTableModel::filters = {
   {FilterMode::ALL,
@@ -174,9 +204,227 @@ const QList<PointsTableModel::FilterInfo> PointsTableModel::filters = {
    }},
 };
 
+QVector<FilterRule> PointsTableModel::builtinFilterRules() {
+  using O = FilterRule::Operation;
+  auto not_in_src_xml = static_cast<int>(FilterMode::NOT_IN_SRC_XML);
+  auto not_in_dbid = static_cast<int>(FilterMode::NOT_IN_DBID);
+  auto frequency_missmatch =
+      static_cast<int>(FilterMode::SCANGROUP_BROADCAST_FREQUENCY_MISSMATCH);
+  QVector<FilterRule> rules = {
+    {not_in_src_xml, {},
+     {{P::KKS, O::NOT_IN_FILE, "SRC"}, {P::KKS, O::NOT_IN_FILE, "XML"}},
+     "Точка присутствует в DBID, но отсутствует в других файлах", {}, {}},
+    {not_in_dbid, {},
+     {{P::KKS, O::NOT_IN_FILE, "DBID"}},
+     "Точка отсутствует в DBID, но присутствует в других файлах", {}, {}},
+    {frequency_missmatch, "frequency",
+     {{P::SCANGROUP_FREQUENCY, O::NOT_EMPTY},
+      {P::BROADCAST_FREQUENCY, O::NOT_EQUAL, "A"},
+      {P::BROADCAST_FREQUENCY, O::EQUAL, "S"},
+      {P::SCANGROUP_FREQUENCY, O::EQUAL, "0.1"}},
+     "Быстрая скангруппа не соответствует медленной частоте передачи",
+     {P::BROADCAST_FREQUENCY, P::SCANGROUP_FREQUENCY}, {}},
+    {frequency_missmatch, "frequency",
+     {{P::SCANGROUP_FREQUENCY, O::NOT_EMPTY},
+      {P::BROADCAST_FREQUENCY, O::NOT_EQUAL, "A"},
+      {P::BROADCAST_FREQUENCY, O::EQUAL, "F"},
+      {P::SCANGROUP_FREQUENCY, O::EQUAL, "1"}},
+     "Медленная скангруппа не соответствует быстрой частоте передачи",
+     {}, {P::BROADCAST_FREQUENCY, P::SCANGROUP_FREQUENCY}},
+    {frequency_missmatch, "frequency",
+     {{P::SCANGROUP_FREQUENCY, O::NOT_EMPTY},
+      {P::BROADCAST_FREQUENCY, O::NOT_EQUAL, "A"},
+      {P::SCANGROUP_FREQUENCY, O::NOT_EQUAL, "0.1"},
+      {P::SCANGROUP_FREQUENCY, O::NOT_EQUAL, "1"}},
+     "Нестандартная скангруппа",
+     {P::SCANGROUP_FREQUENCY}, {}}
+  };
+
+  // The scales are checked if the operating range differs from the limits
+  // or from the scale. Every pair of set and different scales is reported,
+  // then the missing scales one per line.
+  auto scale = static_cast<int>(FilterMode::SCALE_ERRORS);
+  const QVector<QPair<P, P>> scale_pairs = {
+    {P::OPERATING_RANGE_LOW, P::LOW_ENGINEERING_LIMIT},
+    {P::OPERATING_RANGE_HIGH, P::HIGH_ENGINEERING_LIMIT},
+    {P::OPERATING_RANGE_LOW, P::MINIMUM_SCALE},
+    {P::OPERATING_RANGE_HIGH, P::MAXIMUM_SCALE},
+    {P::LOW_ENGINEERING_LIMIT, P::MINIMUM_SCALE},
+    {P::HIGH_ENGINEERING_LIMIT, P::MAXIMUM_SCALE}
+  };
+  const QVector<P> scales = {
+    P::OPERATING_RANGE_LOW, P::OPERATING_RANGE_HIGH,
+    P::LOW_ENGINEERING_LIMIT, P::HIGH_ENGINEERING_LIMIT,
+    P::MINIMUM_SCALE, P::MAXIMUM_SCALE
+  };
+  QVector<FilterRule::Condition> range_differs;
+  for (int i = 0; i < 4; ++i) {
+    range_differs.append(
+          {scale_pairs[i].first, O::NOT_EQUAL, scale_pairs[i].second});
+  }
+  QVector<FilterRule::Condition> scale_missing;
+  for (auto parameter : scales) {
+    scale_missing.append({parameter, O::EMPTY});
+  }
+  for (const auto& pair : scale_pairs) {
+    auto first = PointInfo::toString(pair.first);
+    auto second = PointInfo::toString(pair.second);
+    rules.append({scale, {},
+                  {FilterRule::any(range_differs),
+                   {pair.first, O::NOT_EMPTY},
+                   {pair.second, O::NOT_EMPTY},
+                   {pair.first, O::NOT_EQUAL, pair.second}},
+                  "Несоответствие значений " + first + " и " + second
+                  + "\n{" + first + "} != {" + second + "}",
+                  {pair.first, pair.second}, {}});
+  }
+  rules.append({scale, {},
+                {FilterRule::any(range_differs),
+                 FilterRule::any(scale_missing)},
+                "Некоторые шкалы отсутствуют:", {}, {}});
+  for (auto parameter : scales) {
+    rules.append({scale, {},
+                  {FilterRule::any(range_differs), {parameter, O::EMPTY}},
+                  PointInfo::toString(parameter), {}, {parameter}});
+  }
+  return rules;
+}
+
+QVector<FilterRule> PointsTableModel::optionFilterRules() const {
+  using O = FilterRule::Operation;
+  QVector<FilterRule> rules;
+
+  auto characteristics = static_cast<int>(FilterMode::CHARACTERISTICS_ERRORS);
+  for (const auto& mask : characteristicsFilter.masks) {
+    if (!mask.mask.isEmpty()) {
+      rules.append({characteristics, {},
+                    {{P::CHARACTERISTICS, O::NOT_EMPTY},
+                     {P::CHARACTERISTICS,
+                      mask.compare_equal ? O::MATCHES : O::NOT_MATCHES,
+                      mask.mask}},
+                    "Характеристика ({CHARACTERISTICS}) не соответствует "
+                    "маске (" + mask.mask + ")", {}, {}});
+    }
+  }
+
+  // The location of an XQ02 point is compared through its XQ01 point. The
+  // parameters are colored as warnings when they are empty.
+  auto ancillary = static_cast<int>(FilterMode::ANCILLARY_ERRORS);
+  const QVector<QPair<QString, QString>> xq01_link = {{"_XQ02", "XQ01"},
+                                                      {"XQ02", "XQ01"}};
+  const auto& order = ancillaryFilter.order;
+  QVector<FilterRule::Condition> ancillary_conditions = {
+    {P::TYPE, O::NOT_EQUAL,
+     PointInfo::toString(PointInfo::Type::ModulePoint)},
+    FilterRule::any({{order[P::DROP].second, O::NOT_EMPTY},
+                     {FilterRule::linked(P::IO_CHANNEL), O::NOT_EMPTY},
+                     {order[P::IO_CHANNEL].second, O::NOT_EMPTY}})
+  };
+  struct AncillaryCheck {
+    P parameter;
+    QString value;
+    FilterRule::Condition differs;
+  };
+  QVector<AncillaryCheck> ancillary_checks;
+  if (order[P::DROP].first) {
+    auto anc_drop = PointInfo::toString(order[P::DROP].second);
+    ancillary_checks.append(
+          {P::DROP, "{DROP}",
+           {P::DROP, O::NOT_EQUAL,
+            "DROP{" + anc_drop + "}/DROP{" + anc_drop + "+50}"}});
+  }
+  for (auto parameter : {P::IO_LOCATION, P::IO_CHANNEL}) {
+    if (order[parameter].first) {
+      ancillary_checks.append(
+            {parameter, "{link." + PointInfo::toString(parameter) + "}",
+             {FilterRule::linked(parameter), O::NOT_EQUAL,
+              order[parameter].second}});
+    }
+  }
+  if (!ancillary_checks.isEmpty()) {
+    QVector<FilterRule::Condition> any_differs;
+    for (const auto& check : ancillary_checks) {
+      any_differs.append(check.differs);
+    }
+    rules.append({ancillary, {},
+                  ancillary_conditions
+                  + QVector<FilterRule::Condition>{
+                    {P::KKS, O::NOT_EQUAL, FilterRule::linked(P::KKS)},
+                    FilterRule::any(any_differs)},
+                  "Проверяется соответствующая XQ01 точка - {link.KKS}",
+                  {}, {}, xq01_link});
+  }
+  for (const auto& check : ancillary_checks) {
+    auto anc_parameter = order[check.parameter].second;
+    auto conditions = ancillary_conditions
+        + QVector<FilterRule::Condition>{check.differs};
+    rules.append({ancillary, {}, conditions,
+                  PointInfo::toString(check.parameter) + " (" + check.value
+                  + ") не соответствует "
+                  + PointInfo::toString(anc_parameter)
+                  + " ({" + PointInfo::toString(anc_parameter) + "})",
+                  {}, {}, xq01_link});
+    for (auto parameter : {check.parameter, anc_parameter}) {
+      auto group = "ancillary " + PointInfo::toString(check.parameter)
+          + " " + PointInfo::toString(parameter);
+      rules.append({ancillary, group,
+                    conditions
+                    + QVector<FilterRule::Condition>{{parameter, O::EMPTY}},
+                    {}, {}, {parameter}, xq01_link});
+      rules.append({ancillary, group, conditions, {}, {parameter}, {},
+                    xq01_link});
+    }
+  }
+
+  auto limits_priority = static_cast<int>(FilterMode::LIMITS_PRIORITY_ERRORS);
+  for (auto it = alarmsFilter.priority.keyValueBegin();
+       it != alarmsFilter.priority.keyValueEnd(); ++it) {
+    auto parameter = (*it).first;
+    auto enabled = (*it).second.first;
+    auto value = QString::number((*it).second.second);
+    if (enabled) {
+      rules.append({limits_priority, {},
+                    {{P::TYPE, O::EQUAL,
+                      PointInfo::toString(PointInfo::Type::AnalogPoint)},
+                     FilterRule::any({{parameter, O::LESS, value},
+                                      {parameter, O::GREATER, value}})},
+                    PointInfo::toString(parameter) + " != " + value,
+                    {}, {parameter}});
+    }
+  }
+  return rules;
+}
+
+// "FilterRules" is an array of rules in the FilterRule::fromJson format with
+// the "mode" key naming the filter the rule reports to
+QVector<FilterRule> PointsTableModel::customFilterRules() {
+  QVector<FilterRule> rules;
+  auto modes = QMetaEnum::fromType<FilterMode>();
+  for (const auto& rule_json : global_settings["FilterRules"].toArray()) {
+    auto rule_object = rule_json.toObject();
+    auto mode = modes.keyToValue(
+          qUtf8Printable(rule_object["mode"].toString()));
+    FilterRule rule;
+    if (mode <= static_cast<int>(FilterMode::ALL)
+        || !FilterRule::fromJson(rule_object, rule)) {
+      invalid_filter_rules.append(
+            QJsonDocument(rule_object).toJson(QJsonDocument::Compact));
+      continue;
+    }
+    rule.mode = mode;
+    rules.append(rule);
+  }
+  return rules;
+}
+
+void PointsTableModel::compileFilterRules() {
+  filter_rule_plan = FilterRulePlan::compile(
+        builtinFilterRules() + optionFilterRules() + custom_filter_rules);
+}
+
 int PointsTableModel::rowCount(
         [[maybe_unused]] const QModelIndex& parent) const {
-  return points.size();
+  return point_store.size();
 }
 
 int PointsTableModel::columnCount(
@@ -187,11 +435,8 @@ int PointsTableModel::columnCount(
 QVariant PointsTableModel::data(const QModelIndex& index, int role) const {
   if (role == Qt::DisplayRole
       || role == Qt::ForegroundRole) {
-    auto point = (*points[index.row()]);
-    auto parameter = headerData(index.column(),
-                                Qt::Horizontal,
-                                Qt::DisplayRole).toString();
-    auto value = point[PointInfo::parameterFromString(parameter)];
+    const auto& value = point_store.value(
+          index.row(), PointInfo::point_parameters[index.column()]);
 //    if (value.isNull()) {
 //      if (role == Qt::DisplayRole) {
 //        return "Null";
@@ -227,130 +472,32 @@ QVariant PointsTableModel::headerData(int section,
 }
 
 QVector<QHash<PointInfo::Parameter, QString>> PointsTableModel::loadDbidRootItem(
-        Loader::DbidTreeItem* dbidRootItem) {
+        const DbidTree& dbid_tree,
+        QSharedPointer<const PlantTopology> plant_topology) {
   emit updateStatus("Генерация данных о точках и модулях. Подождите...");
-  std::function<Loader::DbidTreeItem*
-          (Loader::DbidTreeItem*, const QPair<QString, QString>&)> findItem =
-      [&findItem](Loader::DbidTreeItem* root_item,
-          const QPair<QString, QString>& keys) -> Loader::DbidTreeItem* {
-    if (root_item == nullptr)
-      return nullptr;
-    if ((keys.first.isEmpty() && keys.second.isEmpty())
-       || (root_item->parameter.startsWith(keys.first)
-           && root_item->value.startsWith(keys.second)))
-      return root_item;
-    for (auto child : root_item->children) {
-      auto result = findItem(child, keys);
-      if (result != nullptr)
-        return result;
-    }
-    return nullptr;
-  };
-  std::function<QList<Loader::DbidTreeItem*>
-          (Loader::DbidTreeItem*, const QPair<QString, QString>&)> findItems =
-      [](Loader::DbidTreeItem* root_item,
-          const QPair<QString, QString>& keys) -> QList<Loader::DbidTreeItem*> {
-    if (root_item == nullptr || root_item->children.isEmpty())
-      return {};
-    QList<Loader::DbidTreeItem*> result;
-    for (auto child : root_item->children) {
-      if (child->parameter.startsWith(keys.first)
-              && child->value.startsWith(keys.second))
-        result.append(child);
-    }
-    return result;
-  };
-  auto unit_item = findItem(dbidRootItem, {"UNIT", "Unit"});
-
+  this->plant_topology = plant_topology;
   QVector<QHash<PointInfo::Parameter, QString>> container;
 
-  if (unit_item != nullptr) {
-    auto drop_items = findItems(unit_item, {"", "Drop"});
-    for (const auto& drop_item : drop_items) {
-      auto io_device_item = findItem(drop_item,
-                                     {"I/O Device 0 IOIC", "IoDevice"});
-      auto io_interface_items = findItems(io_device_item,
-                                          {"I/O Interface ", "IoDevice"});
-      for (auto io_interface_item : io_interface_items) {
-        auto io_interface_number =
-                io_interface_item->parameter.mid(
-                    QString("I/O Interface ").length(), 1);
-        if (io_interface_number == "1" || io_interface_number == "2") {
-          auto branch_items = findItems(io_interface_item,
-                                        {"Branch ", "Branch"});
-          for (auto branch_item : branch_items) {
-            auto slot_items = findItems(branch_item,
-                                        {"Slot ", "RSlot"});
-            for (auto slot_item : slot_items) {
-              auto module_items = findItems(slot_item,
-                                            {"", "RModule"});
-              for (auto module_item : module_items) {
-                auto drop_number =
-                        drop_item->parameter.mid(QString("DROP").length(), 2);
-                auto branch_number =
-                        branch_item->parameter.mid(QString("Branch ").length(),
-                                                   1);
-                auto slot_number =
-                        slot_item->parameter.mid(QString("Slot ").length(), 1);
-                auto module_point_name_item = findItem(module_item,
-                                                       {"POINT_NAME", ""});
-                if (module_point_name_item != nullptr) {
-                  if (module_point_name_item->value
-                          != QString("MP_") + drop_number + "_"
-                             + io_interface_number + "_" + branch_number
-                             + "_" + slot_number) {
-                    qFatal(qPrintable(module_point_name_item->value
-                                      + " does not refer to real location"));
-                  }
-                } else {
-                  qFatal(qPrintable(module_item->parameter
-                                    + " does not have POINT_NAME"));
-                }
-                auto module_event_tagging_enable_item =
-                        findItem(module_item, {"EVENT_TAGGING_ENABLE", ""});
-                if (module_event_tagging_enable_item != nullptr) {
-                  drop_info[drop_item->parameter]
-                          .module_soe_input_info[io_interface_number
-                                                 + "." + branch_number
-                                                 + "." + slot_number] =
-                          module_event_tagging_enable_item->value;
-                }
-              }
-            }
+  for (PlantTopology::Id drop = 0; drop < plant_topology->dropCount(); ++drop) {
+    auto drop_item = plant_topology->drop(drop).node;
+    for (int row = 0; row < dbid_tree.childCount(drop_item); ++row) {
+      auto point_item = dbid_tree.child(drop_item, row);
+      if (PointInfo::point_types.contains(
+                  PointInfo::typeFromString(dbid_tree.value(point_item)))) {
+        QHash<PointInfo::Parameter, QString> parameters;
+        parameters[PointInfo::Parameter::KKS] = dbid_tree.parameter(point_item);
+        parameters[PointInfo::Parameter::TYPE] = dbid_tree.value(point_item);
+        parameters[PointInfo::Parameter::APPEAR_IN_FILES] = "DBID.imp";
+        parameters[PointInfo::Parameter::DROP] = dbid_tree.parameter(drop_item);
+        for (int i = 0; i < dbid_tree.childCount(point_item); ++i) {
+          auto parameter_item = dbid_tree.child(point_item, i);
+          auto parameter = PointInfo::parameterFromString(
+                      dbid_tree.parameter(parameter_item));
+          if (PointInfo::point_parameters.contains(parameter)) {
+            parameters[parameter] = dbid_tree.value(parameter_item);
           }
         }
-      }
-      auto controller_item = findItem(drop_item,
-                                      {"Controller", "ConfigController"});
-      auto control_task_items = findItems(controller_item,
-                                          {"Control Task ", "ConfigDPUCtrlTask"});
-      for (auto control_task_item : control_task_items) {
-        auto control_task_number =
-                control_task_item->parameter.mid(QString("Control Task ").length(),
-                                                 1);
-        auto periodtime_item = findItem(control_task_item,
-                                        {"periodtime", ""});
-        if (periodtime_item != nullptr)
-          drop_info[drop_item->parameter].task_period_info[control_task_number] =
-                  periodtime_item->value;
-      }
-      for (auto point_item : drop_item->children) {
-        if (PointInfo::point_types.contains(
-                    PointInfo::typeFromString(point_item->value))) {
-          QHash<PointInfo::Parameter, QString> parameters;
-          parameters[PointInfo::Parameter::KKS] = point_item->parameter;
-          parameters[PointInfo::Parameter::TYPE] = point_item->value;
-          parameters[PointInfo::Parameter::APPEAR_IN_FILES] = "DBID.imp";
-          parameters[PointInfo::Parameter::DROP] = drop_item->parameter;
-          for (auto parameter_item : point_item->children) {
-            auto parameter =
-                    PointInfo::parameterFromString(parameter_item->parameter);
-            if (PointInfo::point_parameters.contains(parameter)) {
-              parameters[parameter] = parameter_item->value;
-            }
-          }
-          container.append(parameters);
-        }
+        container.append(parameters);
       }
     }
   }
@@ -362,8 +509,7 @@ QVector<QHash<PointInfo::Parameter, QString>> PointsTableModel::loadDbidRootItem
 QColor PointsTableModel::getCellColor(int row,
                                       int column,
                                       int filter_mode) const {
-  auto kks = (*points[row])[P::KKS];
-  return filtering.getErrorColor(kks, filters[filter_mode].mode,
+  return filtering.getErrorColor(row, filters[filter_mode].mode,
                                  PointInfo::point_parameters[column]);
 }
 
@@ -372,622 +518,787 @@ void PointsTableModel::loadPoints(
   emit updateStatus("Загрузка данных о всех точках в модель. Подождите...");
   if (!container.isEmpty()) {
     beginResetModel();
+    QVector<int> changed_rows;
+    QBitArray changed(point_store.size());
+    // Every parameter of a new point is changed, it may also be linked to
+    // the existing points
+    QBitArray changed_columns(PointInfo::point_parameters.size());
     int i = 0;
     for (const auto& parameters : container) {
-      const auto& kks = parameters[P::KKS];
-      if (!kks.isEmpty()) {
+      const auto& kks_string = parameters[P::KKS];
+      if (!kks_string.isEmpty()) {
+        auto kks = StringPool::instance().intern(kks_string);
         if (!point_index_by_name.contains(kks)) {
-          point_index_by_name.insert(kks, points.size());
-          if (parameters[P::TYPE]
-                  != PointInfo::toString(PointInfo::Type::ModulePoint)) {
-            const auto& drop = parameters[P::DROP];
-            const auto& io_location = parameters[P::IO_LOCATION];
-            const auto& task = parameters[P::IO_TASK_INDEX];
-            if (!drop.isEmpty() && !io_location.isEmpty()
-                && !tasks_in_drop_and_location[drop][io_location].contains(task)) {
-              tasks_in_drop_and_location[drop][io_location].append(task);
-            }
-          }
-          points.append(new Point(parameters));
+          point_index_by_name.insert(kks, point_store.size());
+          changed_rows.append(point_store.size());
+          point_store.addPoint(parameters);
+          changed_columns.fill(true);
         } else {
-          points[point_index_by_name[kks]]->addParameters(parameters);
+          auto row = point_index_by_name[kks];
+          point_store.addParameters(row, parameters);
+          for (auto it = parameters.keyBegin();
+               it != parameters.keyEnd(); ++it) {
+            changed_columns.setBit(static_cast<int>(*it));
+          }
+          if (row < changed.size() && !changed.testBit(row)) {
+            changed.setBit(row);
+            changed_rows.append(row);
+          }
         }
       }
       emit updateProgress(std::lround(100.0 * ++i / container.size()));
     }
     emit updateStatus("Загрузка данных о всех точках в модель. Подождите... Завершено");
-    updateFiltering();
+    kks_index.update(point_store);
+    updateModuleTasks();
+    std::sort(changed_rows.begin(), changed_rows.end());
+    updateChangedRows(changed_rows, changed_columns);
     endResetModel();
   }
 }
 
 void PointsTableModel::clear() {
   beginResetModel();
-  filtering.clear();
-  drop_info.clear();
-  tasks_in_drop_and_location.clear();
+  filtering = Filtering();
+  plant_topology = QSharedPointer<PlantTopology>::create();
+  module_tasks.clear();
   point_index_by_name.clear();
-  points.clear();
+  point_store.clear();
+  kks_index.clear();
   endResetModel();
 }
 
-void PointsTableModel::Filtering::addErrorInfo(const QString& kks,
+namespace {
+
+  // Severity slots of the parameters shown by every filter, colors of the
+  // hidden columns are never displayed and are not stored
+  struct SeverityLayout {
+    QVector<QVector<int>> slot;
+    QVector<int> slot_count;
+  };
+
+  const SeverityLayout& severityLayout() {
+    static const SeverityLayout layout = [] {
+      SeverityLayout layout;
+      layout.slot.fill(QVector<int>(PointInfo::point_parameters.size(), -1),
+                       PointsTableModel::filters.size());
+      layout.slot_count.fill(0, PointsTableModel::filters.size());
+      for (const auto& filter_info : PointsTableModel::filters) {
+        auto mode = static_cast<int>(filter_info.mode);
+        for (auto parameter : filter_info.shown_parameters) {
+          auto& slot = layout.slot[mode][static_cast<int>(parameter)];
+          if (slot == -1) {
+            slot = layout.slot_count[mode]++;
+          }
+        }
+      }
+      return layout;
+    }();
+    return layout;
+  }
+
+}
+
+PointsTableModel::Filtering::Filtering(int first_row, int row_count)
+    : first_row_(first_row), row_count_(row_count) {
+  clear();
+}
+
+PointsTableModel::Filtering::Filtering(const QVector<int>& rows)
+    : first_row_(0), row_count_(rows.size()), rows_(rows) {
+  clear();
+}
+
+int PointsTableModel::Filtering::index(int row) const {
+  if (rows_.isEmpty()) {
+    auto index = row - first_row_;
+    return index >= 0 && index < row_count_ ? index : -1;
+  }
+  auto it = std::lower_bound(rows_.cbegin(), rows_.cend(), row);
+  return it != rows_.cend() && *it == row ? it - rows_.cbegin() : -1;
+}
+
+int PointsTableModel::Filtering::row(int index) const {
+  return rows_.isEmpty() ? first_row_ + index : rows_[index];
+}
+
+void PointsTableModel::Filtering::addErrorInfo(int row,
                                                FilterMode mode,
                                                const QString& info) {
-  error_info[kks][mode].append(info);
+  auto& results = results_[static_cast<int>(mode)];
+  results.error_rows.setBit(index(row));
+  results.error_info[row].append(info);
 }
 
 void PointsTableModel::Filtering::addErrorColor(
-        const QString& kks,
+        int row,
         FilterMode mode,
         PointInfo::Parameter parameter,
         PointsTableModel::Filtering::InfoType filter_type) {
-  auto& filter_type_ = color_info[kks][mode][parameter];
-  if (filter_type != filter_type_ && filter_type_ != InfoType::ERROR) {
-    filter_type_ = filter_type;
+  const auto& layout = severityLayout();
+  auto mode_index = static_cast<int>(mode);
+  auto slot = layout.slot[mode_index][static_cast<int>(parameter)];
+  if (slot == -1) {
+    return;
+  }
+  auto& severities = results_[mode_index].severities;
+  auto slot_count = layout.slot_count[mode_index];
+  if (severities.isEmpty()) {
+    severities.fill(0, (row_count_ * slot_count * 2 + 31) / 32);
   }
+  // An error is never downgraded to a warning
+  auto bit = (index(row) * slot_count + slot) * 2;
+  auto& word = severities[bit / 32];
+  auto shift = bit % 32;
+  auto value = static_cast<quint32>(filter_type) + 1;
+  if (value > ((word >> shift) & 3u)) {
+    word = (word & ~(3u << shift)) | (value << shift);
+  }
+}
+
+bool PointsTableModel::Filtering::hasError(int row, FilterMode mode) const {
+  auto row_index = index(row);
+  return row_index != -1
+      && results_[static_cast<int>(mode)].error_rows.testBit(row_index);
 }
 
-bool PointsTableModel::Filtering::hasError(const QString& kks,
-                                           FilterMode mode) const {
-  return error_info[kks].contains(mode);
+int PointsTableModel::Filtering::severity(int row,
+                                          FilterMode mode,
+                                          int slot) const {
+  auto mode_index = static_cast<int>(mode);
+  const auto& severities = results_[mode_index].severities;
+  auto row_index = index(row);
+  if (severities.isEmpty() || row_index == -1) {
+    return 0;
+  }
+  auto bit = (row_index * severityLayout().slot_count[mode_index] + slot) * 2;
+  return (severities[bit / 32] >> (bit % 32)) & 3u;
 }
 
 QColor PointsTableModel::Filtering::getErrorColor(
-        const QString& kks,
+        int row,
         FilterMode mode,
         PointInfo::Parameter parameter) const {
-  if (color_info.contains(kks)
-          && color_info[kks].contains(mode)
-          && color_info[kks][mode].contains(parameter)) {
-    if (color_info[kks][mode][parameter] == InfoType::ERROR) {
+  auto slot = severityLayout()
+      .slot[static_cast<int>(mode)][static_cast<int>(parameter)];
+  if (slot != -1) {
+    auto value = severity(row, mode, slot);
+    if (value == static_cast<int>(InfoType::ERROR) + 1) {
       return QColor(Qt::GlobalColor::red);
-    } else if (color_info[kks][mode][parameter] == InfoType::WARNING) {
+    } else if (value == static_cast<int>(InfoType::WARNING) + 1) {
       return QColor(Qt::GlobalColor::gray);
     }
   }
   return QColor::Invalid;
 }
 
-QStringList PointsTableModel::Filtering::getErrorInfo(const QString& kks,
+QStringList PointsTableModel::Filtering::getErrorInfo(int row,
                                                       FilterMode mode) const {
-  return error_info[kks][mode];
+  return results_[static_cast<int>(mode)].error_info.value(row);
 }
 
-void PointsTableModel::Filtering::clear(PointsTableModel::FilterMode filter_mode) {
-  for (auto& info : error_info) {
-    info.remove(filter_mode);
-  }
-  for (auto& info : color_info) {
-    info.remove(filter_mode);
+void PointsTableModel::Filtering::clear(
+        PointsTableModel::FilterMode filter_mode) {
+  auto& results = results_[static_cast<int>(filter_mode)];
+  results.error_rows = QBitArray(row_count_);
+  results.error_info.clear();
+  results.severities.clear();
+}
+
+void PointsTableModel::Filtering::clear(
+        PointsTableModel::FilterMode filter_mode,
+        const QVector<int>& rows) {
+  auto mode_index = static_cast<int>(filter_mode);
+  auto& results = results_[mode_index];
+  auto slot_count = severityLayout().slot_count[mode_index];
+  for (auto row : rows) {
+    auto row_index = index(row);
+    results.error_rows.clearBit(row_index);
+    results.error_info.remove(row);
+    if (!results.severities.isEmpty()) {
+      for (int slot = 0; slot < slot_count; ++slot) {
+        auto bit = (row_index * slot_count + slot) * 2;
+        results.severities[bit / 32] &= ~(3u << (bit % 32));
+      }
+    }
   }
 }
 
 void PointsTableModel::Filtering::clear() {
-  error_info.clear();
-  color_info.clear();
+  results_ = QVector<FilterResults>(filters.size());
+  for (const auto& filter_info : filters) {
+    clear(filter_info.mode);
+  }
+}
+
+void PointsTableModel::Filtering::resize(int row_count) {
+  Q_ASSERT(rows_.isEmpty());
+  const auto& layout = severityLayout();
+  row_count_ = row_count;
+  for (int mode_index = 0; mode_index < results_.size(); ++mode_index) {
+    auto& results = results_[mode_index];
+    results.error_rows.resize(row_count);
+    if (!results.severities.isEmpty()) {
+      results.severities.resize(
+            (row_count * layout.slot_count[mode_index] * 2 + 31) / 32);
+    }
+  }
+}
+
+void PointsTableModel::Filtering::merge(const Filtering& other) {
+  Q_ASSERT(rows_.isEmpty());
+  const auto& layout = severityLayout();
+  for (const auto& filter_info : filters) {
+    auto mode = filter_info.mode;
+    auto mode_index = static_cast<int>(mode);
+    const auto& other_results = other.results_[mode_index];
+    auto& results = results_[mode_index];
+    for (auto it = other_results.error_info.keyValueBegin();
+         it != other_results.error_info.keyValueEnd(); ++it) {
+      results.error_rows.setBit(index((*it).first));
+      results.error_info[(*it).first] += (*it).second;
+    }
+    if (other_results.severities.isEmpty()) {
+      continue;
+    }
+    auto slot_count = layout.slot_count[mode_index];
+    QVector<PointInfo::Parameter> slot_parameters(slot_count);
+    for (auto parameter : filter_info.shown_parameters) {
+      slot_parameters[layout.slot[mode_index][static_cast<int>(parameter)]] =
+          parameter;
+    }
+    // Most of the words are zero, only the set severities are copied
+    for (int word_index = 0; word_index < other_results.severities.size();
+         ++word_index) {
+      auto word = other_results.severities[word_index];
+      while (word != 0) {
+        auto shift = qCountTrailingZeroBits(word) & ~1u;
+        auto value = (word >> shift) & 3u;
+        word &= ~(3u << shift);
+        auto pair = (word_index * 32 + static_cast<int>(shift)) / 2;
+        addErrorColor(other.row(pair / slot_count),
+                      mode,
+                      slot_parameters[pair % slot_count],
+                      static_cast<InfoType>(value - 1));
+      }
+    }
+  }
 }
 
 void PointsTableModel::updateFiltering(
         QList<PointsTableModel::FilterMode> filter_modes) {
+  compileFilterRules();
+  QBitArray enabled_modes(filters.size(), filter_modes.isEmpty());
   if (filter_modes.empty()) {
-    filtering.clear();
-  } else {
-    for (const auto& filter_mode : filter_modes) {
-      filtering.clear(filter_mode);
+    filtering = Filtering(0, rowCount());
+  }
+  for (const auto& filter_mode : filter_modes) {
+    enabled_modes.setBit(static_cast<int>(filter_mode));
+    filtering.clear(filter_mode);
+  }
+  QVector<int> rows(rowCount());
+  std::iota(rows.begin(), rows.end(), 0);
+  emit updateStatus("Фильтрация (проверка ошибок). Подождите...");
+  checkPoints(enabled_modes, rows);
+  emit updateStatus("Фильтрация (проверка ошибок). Подождите... Завершено");
+  emit filteringUpdated();
+  emit updateStatus("filteringUpdated()");
+}
+
+void PointsTableModel::updateChangedRows(const QVector<int>& rows,
+                                         const QBitArray& changed_columns) {
+  compileFilterRules();
+  filtering.resize(rowCount());
+  QBitArray changed_row_modes(filters.size());
+  QBitArray all_row_modes(filters.size());
+  for (const auto& filter_info : filters) {
+    auto mode = filter_info.mode;
+    auto dependencies = filterDependencies(mode);
+    if ((dependencies.columns & changed_columns).count(true) == 0) {
+      continue;
+    }
+    if (dependencies.other_rows) {
+      all_row_modes.setBit(static_cast<int>(mode));
+      filtering.clear(mode);
+    } else {
+      changed_row_modes.setBit(static_cast<int>(mode));
+      filtering.clear(mode, rows);
     }
   }
-  int count = 0;
+  QVector<int> all_rows(rowCount());
+  std::iota(all_rows.begin(), all_rows.end(), 0);
   emit updateStatus("Фильтрация (проверка ошибок). Подождите...");
-  for (auto pointer_to_point : points) {
-    const auto& point = *pointer_to_point;
-    auto kks = point[P::KKS];
-    using FilterType = Filtering::InfoType;
-    for (const auto& filter_info : filters) {
-      auto filter_mode = filter_info.mode;
-      auto filter_description = filter_info.description;
-      if (filter_mode == FilterMode::NOT_IN_SRC_XML
-              && (filter_modes.contains(filter_mode)
-                  || filter_modes.isEmpty())) {
-        if (!point.isInSRC() && !point.isInXML()) {
-          filtering.addErrorInfo(
-                      kks,
+  checkPoints(changed_row_modes, rows);
+  checkPoints(all_row_modes, all_rows);
+  emit updateStatus("Фильтрация (проверка ошибок). Подождите... Завершено");
+  emit filteringUpdated();
+  emit updateStatus("filteringUpdated()");
+}
+
+void PointsTableModel::setFilterThreadCount(int count) {
+  filter_thread_count = count;
+}
+
+int PointsTableModel::getFilterThreadCount() const {
+  if (filter_thread_count > 0) {
+    return filter_thread_count;
+  }
+  return std::max(QThread::idealThreadCount(), 1);
+}
+
+const QVector<PointsTableModel::NativeCheck> PointsTableModel::native_checks = {
+  {FilterMode::LIMITS_ERRORS,
+   {P::LOW_ALARM_LIMIT_1_TYPE, P::LOW_ALARM_LIMIT_1_VALUE,
+    P::HIGH_ALARM_LIMIT_1_TYPE, P::HIGH_ALARM_LIMIT_1_VALUE,
+    P::LOW_ALARM_LIMIT_2_TYPE, P::LOW_ALARM_LIMIT_2_VALUE,
+    P::HIGH_ALARM_LIMIT_2_TYPE, P::HIGH_ALARM_LIMIT_2_VALUE,
+    P::LOW_ALARM_LIMIT_3_TYPE, P::LOW_ALARM_LIMIT_3_VALUE,
+    P::HIGH_ALARM_LIMIT_3_TYPE, P::HIGH_ALARM_LIMIT_3_VALUE,
+    P::LOW_ALARM_LIMIT_4_TYPE, P::LOW_ALARM_LIMIT_4_VALUE,
+    P::HIGH_ALARM_LIMIT_4_TYPE, P::HIGH_ALARM_LIMIT_4_VALUE,
+    P::OPERATING_RANGE_LOW, P::OPERATING_RANGE_HIGH},
+   false,
+   &PointsTableModel::checkLimits},
+  // The tasks of a module are gathered from all of its points
+  {FilterMode::SINGLE_MODULE_MULTITASK_ERRORS,
+   {P::TYPE, P::DROP, P::IO_LOCATION, P::IO_TASK_INDEX},
+   true,
+   &PointsTableModel::checkSingleModuleMultitask},
+  // The task periods and the SOE inputs of the modules come from the DBID,
+  // which is loaded with all of the points
+  {FilterMode::BROADCAST_FREQUENCY_TASK_UPDATETIME_MISSMATCH,
+   {P::TYPE, P::DROP, P::IO_TASK_INDEX, P::BROADCAST_FREQUENCY},
+   false,
+   &PointsTableModel::checkBroadcastFrequencyTask},
+  {FilterMode::SOE_INPUT_ERRORS,
+   {P::TYPE, P::DROP, P::IO_LOCATION, P::IO_CHANNEL, P::IO_TASK_INDEX,
+    P::SOE_POINT, P::SOE_ENABLED},
+   false,
+   &PointsTableModel::checkSoeInput}
+};
+
+FilterRulePlan::Dependencies PointsTableModel::filterDependencies(
+    FilterMode mode) const {
+  auto dependencies = filter_rule_plan.dependencies(static_cast<int>(mode));
+  dependencies.columns.resize(PointInfo::point_parameters.size());
+  for (const auto& native_check : native_checks) {
+    if (native_check.mode == mode) {
+      for (auto parameter : native_check.columns) {
+        dependencies.columns.setBit(static_cast<int>(parameter));
+      }
+      dependencies.other_rows |= native_check.other_rows;
+    }
+  }
+  return dependencies;
+}
+
+// Built again from all the points, a reloaded source may move a point to
+// another task
+void PointsTableModel::updateModuleTasks() {
+  module_tasks.clear();
+  auto module_point = PointInfo::toString(PointInfo::Type::ModulePoint);
+  for (int row = 0; row < point_store.size(); ++row) {
+    auto drop = point_store.valueId(row, P::DROP);
+    auto io_location = point_store.valueId(row, P::IO_LOCATION);
+    if (point_store.value(row, P::TYPE) == module_point
+        || point_store.value(row, P::DROP).isEmpty()
+        || point_store.value(row, P::IO_LOCATION).isEmpty()) {
+      continue;
+    }
+    auto& tasks = module_tasks[moduleKey(drop, io_location)];
+    auto task = point_store.valueId(row, P::IO_TASK_INDEX);
+    if (!tasks.contains(task)) {
+      tasks.append(task);
+    }
+  }
+}
+
+quint64 PointsTableModel::moduleKey(StringPool::Id drop,
+                                    StringPool::Id io_location) {
+  return (static_cast<quint64>(static_cast<quint32>(drop)) << 32)
+      | static_cast<quint32>(io_location);
+}
+
+// Counted like the rule of the mask reports, every distinct characteristic
+// is matched once
+int PointsTableModel::characteristicsErrorCount(
+    const CharacteristicsFilter::Mask& mask) const {
+  const WildcardMask compiled_mask(mask.mask);
+  if (compiled_mask.isEmpty()) {
+    return 0;
+  }
+  QHash<StringPool::Id, bool> errors;
+  int count = 0;
+  for (int row = 0; row < point_store.size(); ++row) {
+    auto id = point_store.valueId(row, P::CHARACTERISTICS);
+    auto it = errors.constFind(id);
+    if (it == errors.constEnd()) {
+      const auto& characteristics = point_store.string(id);
+      it = errors.insert(id, !characteristics.isEmpty()
+                         && compiled_mask.matches(characteristics)
+                            == mask.compare_equal);
+    }
+    count += *it;
+  }
+  return count;
+}
+
+void PointsTableModel::checkPoints(const QBitArray& enabled_modes,
+                                   const QVector<int>& rows) {
+  // Every point is checked independently, the rows are split into chunks
+  // which are checked on the filter threads into their own results. The
+  // results are merged in chunk order, so the output is the same as a
+  // serial pass.
+  const int row_count = rows.size();
+  if (row_count == 0 || enabled_modes.count(true) == 0) {
+    return;
+  }
+  filter_rule_plan.prepare(point_store, rows);
+  const int thread_count = getFilterThreadCount();
+  if (thread_count == 1) {
+    // A serial pass checks straight into the results, without the chunks
+    for (int i = 0; i < row_count; ++i) {
+      checkPoint(rows[i], enabled_modes, filtering);
+      if ((i + 1) % 256 == 0 || i + 1 == row_count) {
+        emit updateProgress(
+                    static_cast<int>(std::floor(100.0 * (i + 1) / row_count)));
+      }
+    }
+    return;
+  }
+  const int chunk_size = std::max(row_count / (thread_count * 8), 256);
+  const int chunk_count = (row_count + chunk_size - 1) / chunk_size;
+  QVector<Filtering> chunk_results;
+  chunk_results.reserve(chunk_count);
+  for (int chunk = 0; chunk < chunk_count; ++chunk) {
+    // A chunk of scattered changed rows only keeps results for its rows
+    auto begin = chunk * chunk_size;
+    auto end = std::min(begin + chunk_size, row_count);
+    auto first_row = rows[begin];
+    if (rows[end - 1] - first_row + 1 == end - begin) {
+      chunk_results.append(Filtering(first_row, end - begin));
+    } else {
+      chunk_results.append(Filtering(rows.mid(begin, end - begin)));
+    }
+  }
+  auto chunk_results_data = chunk_results.data();
+  QAtomicInt next_chunk = 0;
+  QAtomicInt checked_row_count = 0;
+  auto worker = [&] {
+    int chunk;
+    while ((chunk = next_chunk.fetchAndAddRelaxed(1)) < chunk_count) {
+      auto end = std::min((chunk + 1) * chunk_size, row_count);
+      for (auto i = chunk * chunk_size; i < end; ++i) {
+        checkPoint(rows[i], enabled_modes, chunk_results_data[chunk]);
+      }
+      auto chunk_row_count = end - chunk * chunk_size;
+      auto checked =
+          checked_row_count.fetchAndAddRelaxed(chunk_row_count)
+          + chunk_row_count;
+      emit updateProgress(
+                  static_cast<int>(std::floor(100.0 * checked / row_count)));
+    }
+  };
+  ThreadRunner::runWorkers(std::min(thread_count, chunk_count), worker);
+  for (auto& chunk_result : chunk_results) {
+    filtering.merge(chunk_result);
+  }
+}
+
+void PointsTableModel::checkPoint(int row,
+                                  const QBitArray& enabled_modes,
+                                  Filtering& result) const {
+  const Point point(point_store, row);
+  using FilterType = Filtering::InfoType;
+  filter_rule_plan.evaluate(
+        point_store,
+        point_index_by_name,
+        row,
+        [&enabled_modes](int mode) {
+          return enabled_modes.testBit(mode);
+        },
+        [row, &result](int mode,
+                       const QString& message,
+                       const QVector<FilterRulePlan::Color>& colors) {
+          auto filter_mode = static_cast<FilterMode>(mode);
+          if (!message.isEmpty()) {
+            result.addErrorInfo(row, filter_mode, message);
+          }
+          for (const auto& color : colors) {
+            result.addErrorColor(
+                  row,
+                  filter_mode,
+                  color.parameter,
+                  color.severity == FilterRulePlan::Severity::ERROR
+                  ? FilterType::ERROR : FilterType::WARNING);
+          }
+        });
+  for (const auto& native_check : native_checks) {
+    if (enabled_modes.testBit(static_cast<int>(native_check.mode))) {
+      (this->*native_check.check)(row, point, native_check.mode, result);
+    }
+  }
+}
+
+void PointsTableModel::checkLimits(int row,
+                                   const Point& point,
+                                   FilterMode filter_mode,
+                                   Filtering& result) const {
+  using FilterType = Filtering::InfoType;
+  QList<P> missing_operating_ranges;
+  for (auto [p_low_type, p_low_value, p_high_type, p_high_value] :
+       QList<std::tuple<P, P, P, P>>{
+  {P::LOW_ALARM_LIMIT_1_TYPE, P::LOW_ALARM_LIMIT_1_VALUE,
+       P::HIGH_ALARM_LIMIT_1_TYPE, P::HIGH_ALARM_LIMIT_1_VALUE},
+  {P::LOW_ALARM_LIMIT_2_TYPE, P::LOW_ALARM_LIMIT_2_VALUE,
+       P::HIGH_ALARM_LIMIT_2_TYPE, P::HIGH_ALARM_LIMIT_2_VALUE},
+  {P::LOW_ALARM_LIMIT_3_TYPE, P::LOW_ALARM_LIMIT_3_VALUE,
+       P::HIGH_ALARM_LIMIT_3_TYPE, P::HIGH_ALARM_LIMIT_3_VALUE},
+  {P::LOW_ALARM_LIMIT_4_TYPE, P::LOW_ALARM_LIMIT_4_VALUE,
+       P::HIGH_ALARM_LIMIT_4_TYPE, P::HIGH_ALARM_LIMIT_4_VALUE}
+}) {
+    auto low_type = point[p_low_type];
+    auto low_value = point[p_low_value];
+    auto high_type = point[p_high_type];
+    auto high_value = point[p_high_value];
+    for (auto [p_type, type, p_value, value] :
+         QList<std::tuple<P, QString, P, QString>>{
+    {p_low_type, low_type, p_low_value, low_value},
+    {p_high_type, high_type, p_high_value, high_value}
+  }) {
+      if (type == "V" && value.isEmpty()) {
+        result.addErrorInfo(row,
+                            filter_mode,
+                            PointInfo::toString(p_type)
+                            + " = \"V\", но значение "
+                            + PointInfo::toString(p_value)
+                            + " отсутствует");
+        result.addErrorColor(row,
+                             filter_mode,
+                             p_type,
+                             FilterType::WARNING);
+        result.addErrorColor(row,
+                             filter_mode,
+                             p_value,
+                             FilterType::WARNING);
+      } else if (type.isEmpty() && !value.isEmpty()) {
+        result.addErrorInfo(row,
+                            filter_mode,
+                            PointInfo::toString(p_type)
+                            + " отсутствует, но значение "
+                            + PointInfo::toString(p_value)
+                            + " задано");
+        result.addErrorColor(row,
+                             filter_mode,
+                             p_type,
+                             FilterType::WARNING);
+        result.addErrorColor(row,
+                             filter_mode,
+                             p_value,
+                             FilterType::WARNING);
+      }
+      if (!value.isEmpty()) {
+        auto f_value = point_store.number(row, p_value);
+        if (point[P::OPERATING_RANGE_LOW].isEmpty()) {
+          missing_operating_ranges.append(P::OPERATING_RANGE_LOW);
+        } else if (f_value
+                   < point_store.number(row, P::OPERATING_RANGE_LOW)) {
+          result.addErrorInfo(
+                      row,
                      filter_mode,
-                     "Точка присутствует в DBID, но отсутствует в других файлах");
+                     PointInfo::toString(p_value)
+                     + " ниже чем "
+                     + PointInfo::toString(P::OPERATING_RANGE_LOW));
+          result.addErrorInfo(row,
+                              filter_mode,
+                              value + " < "
+                              + point[P::OPERATING_RANGE_LOW]);
+          result.addErrorColor(row, filter_mode, p_value);
         }
-      } else if (filter_mode == FilterMode::NOT_IN_DBID
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (!point.isInDBID()) {
-          filtering.addErrorInfo(
-                      kks,
+        if (point[P::OPERATING_RANGE_HIGH].isEmpty()) {
+          missing_operating_ranges.append(P::OPERATING_RANGE_HIGH);
+        } else if (f_value
+                   > point_store.number(row, P::OPERATING_RANGE_HIGH)) {
+          result.addErrorInfo(
+                      row,
                      filter_mode,
-                     "Точка отсутствует в DBID, но присутствует в других файлах");
+                     PointInfo::toString(p_value)
+                     + " выше чем "
+                     + PointInfo::toString(P::OPERATING_RANGE_HIGH));
+          result.addErrorInfo(row,
+                              filter_mode,
+                              value + " > "
+                              + point[P::OPERATING_RANGE_HIGH]);
+          result.addErrorColor(row, filter_mode, p_value);
         }
-      } else if (filter_mode == FilterMode::SCALE_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if ((point[P::OPERATING_RANGE_LOW] != point[P::LOW_ENGINEERING_LIMIT])
-            || (point[P::OPERATING_RANGE_LOW] != point[P::MINIMUM_SCALE])
-            || (point[P::OPERATING_RANGE_HIGH] != point[P::HIGH_ENGINEERING_LIMIT])
-            || (point[P::OPERATING_RANGE_HIGH] != point[P::MAXIMUM_SCALE])) {
-          bool empty = false;
-          for (const auto& pair : QList<QPair<P, P>>({
-              {P::OPERATING_RANGE_LOW, P::LOW_ENGINEERING_LIMIT},
-              {P::OPERATING_RANGE_HIGH, P::HIGH_ENGINEERING_LIMIT},
-              {P::OPERATING_RANGE_LOW, P::MINIMUM_SCALE},
-              {P::OPERATING_RANGE_HIGH, P::MAXIMUM_SCALE},
-              {P::LOW_ENGINEERING_LIMIT, P::MINIMUM_SCALE},
-              {P::HIGH_ENGINEERING_LIMIT, P::MAXIMUM_SCALE}
-            })) {
-            auto first = point[pair.first];
-            auto second = point[pair.second];
-            if (first.isEmpty() || second.isEmpty())
-              empty = true;
-            if (!first.isEmpty() && !second.isEmpty() && (first != second)) {
-              filtering.addErrorInfo(
-                          kks,
-                          filter_mode,
-                          "Несоответствие значений "
-                          + PointInfo::toString(pair.first)
-                          + " и " + PointInfo::toString(pair.second));
-              filtering.addErrorInfo(kks, filter_mode, first + " != " + second);
-              filtering.addErrorColor(kks, filter_mode, pair.first);
-              filtering.addErrorColor(kks, filter_mode, pair.second);
-            }
-          }
-          if (empty) {
-            filtering.addErrorInfo(kks,
-                                   filter_mode,
-                                   "Некоторые шкалы отсутствуют:");
-            QList<P> error_parameters;
-            for (auto limit : {
-                 P::OPERATING_RANGE_LOW, P::OPERATING_RANGE_HIGH,
-                 P::LOW_ENGINEERING_LIMIT, P::HIGH_ENGINEERING_LIMIT,
-                 P::MINIMUM_SCALE, P::MAXIMUM_SCALE}) {
-              if (point[limit].isEmpty()) {
-                filtering.addErrorColor(kks,
-                                        filter_mode,
-                                        limit,
-                                        FilterType::WARNING);
-                error_parameters.append(limit);
-              }
-            }
-            QStringList error_parameter_string;
-            for (auto p : error_parameters) {
-              error_parameter_string.append(PointInfo::toString(p));
-              filtering.addErrorColor(kks, filter_mode, p, FilterType::WARNING);
-            }
-            filtering.addErrorInfo(kks,
-                                   filter_mode,
-                                   error_parameter_string.join(", "));
-          }
+        if (value == low_value
+                && !high_value.isEmpty()
+                && f_value >= point_store.number(row, p_high_value)) {
+          result.addErrorInfo(row,
+                              filter_mode,
+                              PointInfo::toString(p_low_value)
+                              + " выше или равно "
+                              + PointInfo::toString(p_high_value));
+          result.addErrorInfo(row,
+                              filter_mode,
+                              value + " >= " + high_value);
+          result.addErrorColor(row, filter_mode, p_value);
+          result.addErrorColor(row, filter_mode, p_high_value);
         }
-      } else if (filter_mode == FilterMode::LIMITS_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        QList<P> missing_operating_ranges;
-        for (auto [p_low_type, p_low_value, p_high_type, p_high_value] :
-             QList<std::tuple<P, P, P, P>>{
-        {P::LOW_ALARM_LIMIT_1_TYPE, P::LOW_ALARM_LIMIT_1_VALUE,
-             P::HIGH_ALARM_LIMIT_1_TYPE, P::HIGH_ALARM_LIMIT_1_VALUE},
-        {P::LOW_ALARM_LIMIT_2_TYPE, P::LOW_ALARM_LIMIT_2_VALUE,
-             P::HIGH_ALARM_LIMIT_2_TYPE, P::HIGH_ALARM_LIMIT_2_VALUE},
-        {P::LOW_ALARM_LIMIT_3_TYPE, P::LOW_ALARM_LIMIT_3_VALUE,
-             P::HIGH_ALARM_LIMIT_3_TYPE, P::HIGH_ALARM_LIMIT_3_VALUE},
-        {P::LOW_ALARM_LIMIT_4_TYPE, P::LOW_ALARM_LIMIT_4_VALUE,
-             P::HIGH_ALARM_LIMIT_4_TYPE, P::HIGH_ALARM_LIMIT_4_VALUE}
-      }) {
-          auto low_type = point[p_low_type];
-          auto low_value = point[p_low_value];
-          auto high_type = point[p_high_type];
-          auto high_value = point[p_high_value];
-          for (auto [p_type, type, p_value, value] :
-               QList<std::tuple<P, QString, P, QString>>{
-          {p_low_type, low_type, p_low_value, low_value},
-          {p_high_type, high_type, p_high_value, high_value}
-        }) {
-            if (type == "V" && value.isEmpty()) {
-              filtering.addErrorInfo(kks,
-                                     filter_mode,
-                                     PointInfo::toString(p_type)
-                                     + " = \"V\", но значение "
-                                     + PointInfo::toString(p_value)
-                                     + " отсутствует");
-              filtering.addErrorColor(kks,
-                                      filter_mode,
-                                      p_type,
-                                      FilterType::WARNING);
-              filtering.addErrorColor(kks,
-                                      filter_mode,
-                                      p_value,
-                                      FilterType::WARNING);
-            } else if (type.isEmpty() && !value.isEmpty()) {
-              filtering.addErrorInfo(kks,
-                                     filter_mode,
-                                     PointInfo::toString(p_type)
-                                     + " отсутствует, но значение "
-                                     + PointInfo::toString(p_value)
-                                     + " задано");
-              filtering.addErrorColor(kks,
-                                      filter_mode,
-                                      p_type,
-                                      FilterType::WARNING);
-              filtering.addErrorColor(kks,
-                                      filter_mode,
-                                      p_value,
-                                      FilterType::WARNING);
-            }
-            if (!value.isEmpty()) {
-              auto f_value = value.toFloat();
-              if (point[P::OPERATING_RANGE_LOW].isEmpty()) {
-                missing_operating_ranges.append(P::OPERATING_RANGE_LOW);
-              } else if (f_value < point[P::OPERATING_RANGE_LOW].toFloat()) {
-                filtering.addErrorInfo(
-                            kks,
+      }
+    }
+  }
+  for (auto range : missing_operating_ranges) {
+    result.addErrorInfo(
+                row,
+                filter_mode,
+                PointInfo::toString(range)
+                + " отсутствует, хотя установлена один или несколько уставок");
+    result.addErrorColor(row, filter_mode, range);
+  }
+}
+
+void PointsTableModel::checkSingleModuleMultitask(int row,
+                                                  const Point& point,
+                                                  FilterMode filter_mode,
+                                                  Filtering& result) const {
+  if (point[P::TYPE]
+          != PointInfo::toString(PointInfo::Type::ModulePoint)) {
+    auto tasks = module_tasks.constFind(
+          moduleKey(point_store.valueId(row, P::DROP),
+                    point_store.valueId(row, P::IO_LOCATION)));
+    if (tasks != module_tasks.constEnd() && tasks->size() > 1) {
+      result.addErrorInfo(
+                  row,
+                  filter_mode,
+                  "Точка находится в модуле ("
+                  + point[P::DROP] + " "
+                  + point[P::IO_LOCATION]
+                  + "), в котором находятся точки в разных тасках");
+    }
+  }
+}
+
+void PointsTableModel::checkBroadcastFrequencyTask(int row,
+                                                   const Point& point,
+                                                   FilterMode filter_mode,
+                                                   Filtering& result) const {
+  using FilterType = Filtering::InfoType;
+  if (point[P::TYPE] == PointInfo::toString(PointInfo::Type::AnalogPoint)
+          && !point[P::IO_TASK_INDEX].isEmpty()
+          && !point[P::BROADCAST_FREQUENCY].isEmpty()) {
+    const auto& periodtime = plant_topology->taskPeriod(
+          plant_topology->findDrop(point_store.valueId(row, P::DROP)),
+          point_store.valueId(row, P::IO_TASK_INDEX));
+    if (point[P::BROADCAST_FREQUENCY] == "S"
+            && periodtime.toInt() <= 100) {
+      result.addErrorInfo(
+                  row,
+                  filter_mode,
+                  "Низкая частота передачи не соответствует быстрому таску"
+                  "\nIO_TASK_INDEX: " + point[P::IO_TASK_INDEX]
+                  + " (periodtime: " + periodtime + ")");
+      result.addErrorColor(row,
                            filter_mode,
-                           PointInfo::toString(p_value)
-                           + " ниже чем "
-                           + PointInfo::toString(P::OPERATING_RANGE_LOW));
-                filtering.addErrorInfo(kks,
-                                       filter_mode,
-                                       value + " < "
-                                       + point[P::OPERATING_RANGE_LOW]);
-                filtering.addErrorColor(kks, filter_mode, p_value);
-              }
-              if (point[P::OPERATING_RANGE_HIGH].isEmpty()) {
-                missing_operating_ranges.append(P::OPERATING_RANGE_HIGH);
-              } else if (f_value > point[P::OPERATING_RANGE_HIGH].toFloat()) {
-                filtering.addErrorInfo(
-                            kks,
+                           P::IO_TASK_INDEX,
+                           FilterType::WARNING);
+      result.addErrorColor(row,
                            filter_mode,
-                           PointInfo::toString(p_value)
-                           + " выше чем "
-                           + PointInfo::toString(P::OPERATING_RANGE_HIGH));
-                filtering.addErrorInfo(kks,
-                                       filter_mode,
-                                       value + " > "
-                                       + point[P::OPERATING_RANGE_HIGH]);
-                filtering.addErrorColor(kks, filter_mode, p_value);
-              }
-              if (value == low_value
-                      && !high_value.isEmpty()
-                      && f_value >= high_value.toFloat()) {
-                filtering.addErrorInfo(kks,
-                                       filter_mode,
-                                       PointInfo::toString(p_low_value)
-                                       + " выше или равно "
-                                       + PointInfo::toString(p_high_value));
-                filtering.addErrorInfo(kks,
-                                       filter_mode,
-                                       value + " >= " + high_value);
-                filtering.addErrorColor(kks, filter_mode, p_value);
-                filtering.addErrorColor(kks, filter_mode, p_high_value);
-              }
-            }
-          }
-        }
-        for (auto range : missing_operating_ranges) {
-          filtering.addErrorInfo(
-                      kks,
-                      filter_mode,
-                      PointInfo::toString(range)
-                      + " отсутствует, хотя установлена один или несколько уставок");
-          filtering.addErrorColor(kks, filter_mode, range);
-        }
-      } else if (filter_mode == FilterMode::SINGLE_MODULE_MULTITASK_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (point[P::TYPE]
-                != PointInfo::toString(PointInfo::Type::ModulePoint)) {
-          const auto& drop = point[P::DROP];
-          const auto& io_location = point[P::IO_LOCATION];
-          if (tasks_in_drop_and_location.contains(drop)
-                  && tasks_in_drop_and_location[drop].contains(io_location)
-              && tasks_in_drop_and_location[drop][io_location].size() > 1) {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "Точка находится в модуле ("
-                        + drop + " "
-                        + io_location
-                        + "), в котором находятся точки в разных тасках");
-          }
-        }
-      } else if (filter_mode == FilterMode::CHARACTERISTICS_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (!point[P::CHARACTERISTICS].isEmpty()) {
-          QRegExp rx(characteristicsFilter.mask);
-          rx.setPatternSyntax(QRegExp::Wildcard);
-          if (!rx.isEmpty()
-                  && (rx.exactMatch(point[P::CHARACTERISTICS])
-                      == characteristicsFilter.compare_equal)) {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "Характеристика ("
-                        + point[P::CHARACTERISTICS]
-                        + ") не соответствует маске ("
-                        + characteristicsFilter.mask + ")");
-          }
-        }
-      } else if (filter_mode == FilterMode::ANCILLARY_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (point[P::TYPE] != PointInfo::toString(PointInfo::Type::ModulePoint)) {
-          auto temp_kks = kks;
-          if (temp_kks.endsWith("XQ02")) {
-            if (temp_kks.at(temp_kks.length() - 5) == "_") {
-              temp_kks.remove(temp_kks.length() - 5, 1);
-            }
-            temp_kks.replace(temp_kks.length() - 1, 1, "1");
-          }
-          if (!point_index_by_name.contains(temp_kks)) {
-            temp_kks = kks;
-          }
-          const auto& temp_point = *points[point_index_by_name[temp_kks]];
-          const auto& io_location = temp_point[P::IO_LOCATION];
-          const auto& io_channel = temp_point[P::IO_CHANNEL];
-
-          const auto& drop = point[P::DROP];
-          const auto& anc_drop = point[ancillaryFilter.order[P::DROP].second];
-          const auto& anc_io_location =
-                  point[ancillaryFilter.order[P::IO_LOCATION].second];
-          const auto& anc_io_channel =
-                  point[ancillaryFilter.order[P::IO_CHANNEL].second];
-
-          bool drop_check = ancillaryFilter.order[P::DROP].first
-              && (!std::all_of(anc_drop.begin(),
-                               anc_drop.end(),
-                               [](const QChar& c) {return c.isDigit();})
-                || (drop
-                    != "DROP" + anc_drop
-                       + "/DROP" + QString::number(anc_drop.toInt() + 50)));
-          bool io_location_check =
-                  ancillaryFilter.order[P::IO_LOCATION].first
-                  && io_location != anc_io_location;
-          bool io_channel_check =
-                  ancillaryFilter.order[P::IO_CHANNEL].first
-                  && io_channel != anc_io_channel;
-
-          if (!anc_drop.isEmpty()
-              || !io_channel.isEmpty()
-              || !anc_io_channel.isEmpty()
-              || !io_channel.isEmpty()
-              || !anc_io_channel.isEmpty()) {
-            if (temp_kks != kks
-                && (drop_check
-                    || io_location_check
-                    || io_channel_check)) {
-              filtering.addErrorInfo(kks,
-                                     filter_mode,
-                                     "Проверяется соответствующая XQ01 точка - "
-                                     + temp_kks);
-            }
-            for (auto tuple : QList<std::tuple<bool, P, QString, P, QString>>{
-            {drop_check, P::DROP, drop,
-                 ancillaryFilter.order[P::DROP].second, anc_drop},
-            {io_location_check, P::IO_LOCATION, io_location,
-                 ancillaryFilter.order[P::IO_LOCATION].second, anc_io_location},
-            {io_channel_check, P::IO_CHANNEL, io_channel,
-                 ancillaryFilter.order[P::IO_CHANNEL].second, anc_io_channel}
-            }) {
-              auto check = std::get<0>(tuple);
-              auto parameter = std::get<1>(tuple);
-              const auto& parameter_value = std::get<2>(tuple);
-              auto anc_parameter = std::get<3>(tuple);
-              const auto& anc_parameter_value = std::get<4>(tuple);
-              if (check) {
-                filtering.addErrorInfo(kks,
-                                       filter_mode,
-                                       PointInfo::toString(parameter)
-                                       + " (" + parameter_value
-                                       + ") не соответствует "
-                                       + PointInfo::toString(anc_parameter)
-                                       + " (" + anc_parameter_value + ")");
-                filtering.addErrorColor(kks,
-                                        filter_mode,
-                                        parameter,
-                                        point[parameter].isEmpty()
-                                        ? FilterType::WARNING : FilterType::ERROR);
-                filtering.addErrorColor(kks,
-                                        filter_mode,
-                                        anc_parameter,
-                                        point[anc_parameter].isEmpty()
-                                        ? FilterType::WARNING : FilterType::ERROR);
-              }
-            }
-          }
-        }
-      } else if (filter_mode ==
-                 FilterMode::SCANGROUP_BROADCAST_FREQUENCY_MISSMATCH
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (!point[P::SCANGROUP_FREQUENCY].isEmpty()
-                && point[P::BROADCAST_FREQUENCY] != "A") {
-          if (point[P::BROADCAST_FREQUENCY] == "S"
-                  && point[P::SCANGROUP_FREQUENCY] == "0.1") {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "Быстрая скангруппа не соответствует медленной частоте передачи");
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::BROADCAST_FREQUENCY);
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::SCANGROUP_FREQUENCY);
-          } else if (point[P::BROADCAST_FREQUENCY] == "F"
-                     && point[P::SCANGROUP_FREQUENCY] == "1") {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "Медленная скангруппа не соответствует быстрой частоте передачи");
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::BROADCAST_FREQUENCY,
-                                    FilterType::WARNING);
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::SCANGROUP_FREQUENCY,
-                                    FilterType::WARNING);
-          } else if (point[P::SCANGROUP_FREQUENCY] != "0.1"
-                     && point[P::SCANGROUP_FREQUENCY] != "1") {
-            filtering.addErrorInfo(kks, filter_mode, "Нестандартная скангруппа");
-            filtering.addErrorColor(kks, filter_mode, P::SCANGROUP_FREQUENCY);
-          }
-        }
-      } else if (filter_mode
-                 == FilterMode::BROADCAST_FREQUENCY_TASK_UPDATETIME_MISSMATCH
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (point[P::TYPE] == PointInfo::toString(PointInfo::Type::AnalogPoint)
-                && !point[P::IO_TASK_INDEX].isEmpty()
-                && !point[P::BROADCAST_FREQUENCY].isEmpty()) {
-          if (point[P::BROADCAST_FREQUENCY] == "S"
-                  && drop_info[point[P::DROP]]
-                    .task_period_info[point[P::IO_TASK_INDEX]].toInt() <= 100) {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "Низкая частота передачи не соответствует быстрому таску"
-                        "\nIO_TASK_INDEX: " + point[P::IO_TASK_INDEX]
-                        + " (periodtime: "
-                        + drop_info[point[P::DROP]]
-                          .task_period_info[point[P::IO_TASK_INDEX]] + ")");
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::IO_TASK_INDEX,
-                                    FilterType::WARNING);
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::BROADCAST_FREQUENCY,
-                                    FilterType::WARNING);
-          } else if (point[P::BROADCAST_FREQUENCY] == "F"
-                     && drop_info[point[P::DROP]]
-                        .task_period_info[point[P::IO_TASK_INDEX]]
-                        .toInt() > 100) {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "Высокая частота передачи не соответствует медленному таску"
-                        "\nIO_TASK_INDEX: " + point[P::IO_TASK_INDEX]
-                        + " (periodtime: "
-                        + drop_info[point[P::DROP]]
-                          .task_period_info[point[P::IO_TASK_INDEX]] + ")");
-            filtering.addErrorColor(kks, filter_mode, P::IO_TASK_INDEX);
-            filtering.addErrorColor(kks, filter_mode, P::BROADCAST_FREQUENCY);
-          }
-        }
-      } else if (filter_mode == FilterMode::LIMITS_PRIORITY_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (point[P::TYPE]
-                == PointInfo::toString(PointInfo::Type::AnalogPoint)) {
-          for (auto it = alarmsFilter.priority.keyValueBegin();
-               it != alarmsFilter.priority.keyValueEnd(); ++it) {
-            auto parameter = (*it).first;
-            auto enabled = (*it).second.first;
-            auto value = (*it).second.second;
-            if (enabled && point[parameter].toInt() != value) {
-              filtering.addErrorInfo(kks,
-                                     filter_mode,
-                                     PointInfo::toString(parameter)
-                                     + " != " + QString::number(value));
-              filtering.addErrorColor(kks,
-                                      filter_mode,
-                                      parameter,
-                                      FilterType::WARNING);
-            }
-          }
-        }
-      } else if (filter_mode == FilterMode::SOE_INPUT_ERRORS
-                 && (filter_modes.contains(filter_mode)
-                     || filter_modes.isEmpty())) {
-        if (point[P::TYPE] == PointInfo::toString(PointInfo::Type::DigitalPoint)
-            && !point[P::IO_LOCATION].isEmpty()
-            && !point[P::IO_CHANNEL].isEmpty()) {
-          auto soe_point = point[P::SOE_POINT];
-          auto soe_enabled = point[P::SOE_ENABLED];
-          QString soe_input, module_soe_input_info_hex, module_soe_input_info_binary;
-          if (drop_info.value(point[P::DROP])
-                  .module_soe_input_info.contains(point[P::IO_LOCATION])) {
-            module_soe_input_info_hex =
-                    drop_info[point[P::DROP]]
-                    .module_soe_input_info[point[P::IO_LOCATION]];
-            module_soe_input_info_binary =
-                    QString::number(module_soe_input_info_hex
-                                    .toUInt(nullptr, 16), 2);
-            soe_input =
-                    module_soe_input_info_binary
-                    .rightJustified(16, '0')[16 - point[P::IO_CHANNEL].toInt()];
-          }
-          QString info;
-          if (soe_input.isEmpty()) {
-            info = "SOE Input (EVENT_TAGGING_ENABLE) не указан";
-          } else {
-            info = "SOE Input (EVENT_TAGGING_ENABLE): "
-                    + module_soe_input_info_hex + "\n("
-                    + module_soe_input_info_binary.rightJustified(16, '0') + ")"
-                    + " (bit " + point[P::IO_CHANNEL] + ": " + soe_input + ")";
-          }
-          info += "\nSOE_POINT: \"" + soe_point +"\""
-              + "\nSOE_ENABLED: \"" + soe_enabled + "\"";
-          if (soe_point != soe_enabled) {
-            filtering.addErrorInfo(kks, filter_mode, info);
-            filtering.addErrorColor(kks, filter_mode, P::SOE_POINT);
-            filtering.addErrorColor(kks, filter_mode, P::SOE_ENABLED);
-          } else if (soe_input.isEmpty()) {
-            filtering.addErrorInfo(kks, filter_mode, info);
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::SOE_POINT,
-                                    soe_point == "0"
-                                    ? FilterType::WARNING : FilterType::ERROR);
-            filtering.addErrorColor(kks, filter_mode,
-                                    P::SOE_ENABLED,
-                                    soe_enabled == "0"
-                                    ? FilterType::WARNING : FilterType::ERROR);
-          } else if (soe_input != soe_point) {
-            filtering.addErrorInfo(kks, filter_mode, info);
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::SOE_POINT,
-                                    soe_input == "1"
-                                    ? FilterType::WARNING : FilterType::ERROR);
-            filtering.addErrorColor(kks,
-                                    filter_mode,
-                                    P::SOE_ENABLED,
-                                    soe_input == "1"
-                                    ? FilterType::WARNING : FilterType::ERROR);
-          }
-          if (soe_point == "1"
-              && soe_enabled == "1"
-              && drop_info[point[P::DROP]]
-                 .module_soe_input_info[point[P::IO_TASK_INDEX]].toInt() > 100) {
-            filtering.addErrorInfo(
-                        kks,
-                        filter_mode,
-                        "SOE-точка в медленном таске (>100мс)\n"
-                        "IO_TASK_INDEX: " + point[P::IO_TASK_INDEX]
-                        + " (periodtime: "
-                        + drop_info[point[P::DROP]]
-                          .module_soe_input_info[point[P::IO_TASK_INDEX]]
-                        + ")");
-            filtering.addErrorColor(kks, filter_mode, P::IO_TASK_INDEX);
-            filtering.addErrorColor(kks, filter_mode, P::SOE_POINT);
-            filtering.addErrorColor(kks, filter_mode, P::SOE_ENABLED);
-          }
-        }
-      }
+                           P::BROADCAST_FREQUENCY,
+                           FilterType::WARNING);
+    } else if (point[P::BROADCAST_FREQUENCY] == "F"
+               && periodtime.toInt() > 100) {
+      result.addErrorInfo(
+                  row,
+                  filter_mode,
+                  "Высокая частота передачи не соответствует медленному таску"
+                  "\nIO_TASK_INDEX: " + point[P::IO_TASK_INDEX]
+                  + " (periodtime: " + periodtime + ")");
+      result.addErrorColor(row, filter_mode, P::IO_TASK_INDEX);
+      result.addErrorColor(row, filter_mode, P::BROADCAST_FREQUENCY);
+    }
+  }
+}
+
+void PointsTableModel::checkSoeInput(int row,
+                                     const Point& point,
+                                     FilterMode filter_mode,
+                                     Filtering& result) const {
+  using FilterType = Filtering::InfoType;
+  if (point[P::TYPE] == PointInfo::toString(PointInfo::Type::DigitalPoint)
+      && !point[P::IO_LOCATION].isEmpty()
+      && !point[P::IO_CHANNEL].isEmpty()) {
+    auto soe_point = point[P::SOE_POINT];
+    auto soe_enabled = point[P::SOE_ENABLED];
+    QString soe_input, module_soe_input_info_hex, module_soe_input_info_binary;
+    auto drop = plant_topology->findDrop(point_store.valueId(row, P::DROP));
+    auto module = plant_topology->findModule(
+          drop, point_store.valueId(row, P::IO_LOCATION));
+    if (module != PlantTopology::null
+        && plant_topology->module(module).soe_input
+           != StringPool::invalid_id) {
+      module_soe_input_info_hex = point_store.string(
+            plant_topology->module(module).soe_input);
+      module_soe_input_info_binary =
+              QString::number(module_soe_input_info_hex
+                              .toUInt(nullptr, 16), 2);
+      soe_input =
+              module_soe_input_info_binary
+              .rightJustified(16, '0')[16 - point[P::IO_CHANNEL].toInt()];
+    }
+    QString info;
+    if (soe_input.isEmpty()) {
+      info = "SOE Input (EVENT_TAGGING_ENABLE) не указан";
+    } else {
+      info = "SOE Input (EVENT_TAGGING_ENABLE): "
+              + module_soe_input_info_hex + "\n("
+              + module_soe_input_info_binary.rightJustified(16, '0') + ")"
+              + " (bit " + point[P::IO_CHANNEL] + ": " + soe_input + ")";
+    }
+    info += "\nSOE_POINT: \"" + soe_point +"\""
+        + "\nSOE_ENABLED: \"" + soe_enabled + "\"";
+    if (soe_point != soe_enabled) {
+      result.addErrorInfo(row, filter_mode, info);
+      result.addErrorColor(row, filter_mode, P::SOE_POINT);
+      result.addErrorColor(row, filter_mode, P::SOE_ENABLED);
+    } else if (soe_input.isEmpty()) {
+      result.addErrorInfo(row, filter_mode, info);
+      result.addErrorColor(row,
+                           filter_mode,
+                           P::SOE_POINT,
+                           soe_point == "0"
+                           ? FilterType::WARNING : FilterType::ERROR);
+      result.addErrorColor(row, filter_mode,
+                           P::SOE_ENABLED,
+                           soe_enabled == "0"
+                           ? FilterType::WARNING : FilterType::ERROR);
+    } else if (soe_input != soe_point) {
+      result.addErrorInfo(row, filter_mode, info);
+      result.addErrorColor(row,
+                           filter_mode,
+                           P::SOE_POINT,
+                           soe_input == "1"
+                           ? FilterType::WARNING : FilterType::ERROR);
+      result.addErrorColor(row,
+                           filter_mode,
+                           P::SOE_ENABLED,
+                           soe_input == "1"
+                           ? FilterType::WARNING : FilterType::ERROR);
+    }
+    const auto& periodtime = plant_topology->taskPeriod(
+          drop, point_store.valueId(row, P::IO_TASK_INDEX));
+    if (soe_point == "1"
+        && soe_enabled == "1"
+        && periodtime.toInt() > 100) {
+      result.addErrorInfo(
+                  row,
+                  filter_mode,
+                  "SOE-точка в медленном таске (>100мс)\n"
+                  "IO_TASK_INDEX: " + point[P::IO_TASK_INDEX]
+                  + " (periodtime: " + periodtime + ")");
+      result.addErrorColor(row, filter_mode, P::IO_TASK_INDEX);
+      result.addErrorColor(row, filter_mode, P::SOE_POINT);
+      result.addErrorColor(row, filter_mode, P::SOE_ENABLED);
     }
-    emit updateProgress(
-                static_cast<int>(
-                    std::floor(
-                        100.0 * ++count / points.size())));
   }
-  emit updateStatus("Фильтрация (проверка ошибок). Подождите... Завершено");
-  emit filteringUpdated();
-  emit updateStatus("filteringUpdated()");
 }
@@ -2,10 +2,16 @@
 
 #include <QAbstractTableModel>
 
+#include <QBitArray>
 #include <QJsonObject>
 #include <QColor>
 
+#include "filterrule.h"
+#include "kksindex.h"
+#include "planttopology.h"
 #include "point.h"
+#include "pointstore.h"
+#include "stringpool.h"
 #include "loader.h"
 
 class PointsTableModel : public QAbstractTableModel {
@@ -23,18 +29,18 @@ public:
                       int role = Qt::DisplayRole) const override;
 
   QVector<QHash<PointInfo::Parameter, QString>> loadDbidRootItem(
-          Loader::DbidTreeItem* dbidRootItem);
+          const DbidTree& dbid_tree,
+          QSharedPointer<const PlantTopology> plant_topology);
   void loadPoints(
           const QVector<QHash<PointInfo::Parameter, QString>>& container);
 
   void clear();
 
-  struct Drop_info {
-    QMap<QString, QString> module_soe_input_info;
-    QMap<QString, QString> task_period_info;
-  };
-
-  QMap<QString, Drop_info> drop_info;
+  const PointStore& pointStore() const;
+  const KksIndex& kksIndex() const;
+  // Rules of the "FilterRules" setting which could not be read, they are
+  // skipped
+  const QStringList& invalidFilterRules() const;
 
   enum class FilterMode {
     ALL,
@@ -50,6 +56,7 @@ public:
     LIMITS_PRIORITY_ERRORS,
     SOE_INPUT_ERRORS
   };
+  Q_ENUM(FilterMode)
 
   struct FilterInfo {
     FilterMode mode;
@@ -61,39 +68,82 @@ public:
 
   static const QList<FilterInfo> filters;
 
+  // Results are kept per filter: a bit per point row which has errors, the
+  // messages of those rows and a 2-bit severity (none, warning, error) per
+  // row and shown parameter. A Filtering covers row_count rows starting
+  // from first_row, or only the given sorted rows.
   class Filtering {
   public:
     enum class InfoType {
       WARNING, ERROR
     };
 
-    void addErrorInfo(const QString& kks, FilterMode mode, const QString& info);
-    void addErrorColor(const QString& kks,
+    Filtering(int first_row = 0, int row_count = 0);
+    explicit Filtering(const QVector<int>& rows);
+
+    void addErrorInfo(int row, FilterMode mode, const QString& info);
+    void addErrorColor(int row,
                        FilterMode mode,
                        PointInfo::Parameter parameter,
                        InfoType filter_type = InfoType::ERROR);
-    bool hasError(const QString& kks, FilterMode mode) const;
-    QStringList getErrorInfo(const QString& kks, FilterMode mode) const;
-    QColor getErrorColor(const QString& kks,
+    bool hasError(int row, FilterMode mode) const;
+    QStringList getErrorInfo(int row, FilterMode mode) const;
+    QColor getErrorColor(int row,
                          FilterMode mode,
                          PointInfo::Parameter parameter) const;
     void clear(FilterMode filter_mode);
+    void clear(FilterMode filter_mode, const QVector<int>& rows);
     void clear();
+    // Keeps the results of the existing rows, the new rows have no errors
+    void resize(int row_count);
+    // Copies the results of a Filtering over some of the rows, used to join
+    // the results checked in parallel. Only the rows with results are
+    // visited.
+    void merge(const Filtering& other);
   private:
-    QHash<QString, QHash<FilterMode, QStringList>> error_info;
-    QHash<QString, QHash<FilterMode, QHash<PointInfo::Parameter, InfoType>>>
-    color_info;
+    struct FilterResults {
+      QBitArray error_rows;
+      QHash<int, QStringList> error_info;
+      QVector<quint32> severities;
+    };
+
+    int severity(int row, FilterMode mode, int slot) const;
+    // Position of the row in the results, -1 if the row is not covered
+    int index(int row) const;
+    int row(int index) const;
+
+    int first_row_;
+    int row_count_;
+    QVector<int> rows_;
+    QVector<FilterResults> results_;
   } filtering;
 
   QColor getCellColor(int row, int column, int filter_mode) const;
 
+  // Checks all the points for the given filters, for all filters if none
+  // are given
   void updateFiltering(QList<FilterMode> filter_modes = {});
+  // 0 means one thread per core, 1 checks the points serially
+  void setFilterThreadCount(int count);
+  int getFilterThreadCount() const;
 
+  // A point is reported if any of the masks reports its characteristic
   struct CharacteristicsFilter {
-    QString mask = "?-------";
-    bool compare_equal = false;
+    struct Mask {
+      QString mask;
+      bool compare_equal = false;
+
+      bool operator==(const Mask& other) const {
+        return mask == other.mask && compare_equal == other.compare_equal;
+      }
+    };
+    QVector<Mask> masks = {{"?-------", false}};
   } characteristicsFilter;
 
+  // Number of the points the mask would report
+  int characteristicsErrorCount(
+      const CharacteristicsFilter::Mask& mask) const;
+
   struct AncillaryFilter {
     QMap<PointInfo::Parameter, QPair<bool, PointInfo::Parameter>> order = {
       {PointInfo::Parameter::DROP, {true, PointInfo::Parameter::ANC_5}},
@@ -129,9 +179,71 @@ signals:
   void filteringUpdated();
 
 private:
-  QVector<Point*> points;
-  QHash<QString, int> point_index_by_name;
-  QMap<QString, QMap<QString, QStringList>> tasks_in_drop_and_location;
+  PointStore point_store;
+  KksIndex kks_index;
+  QHash<StringPool::Id, int> point_index_by_name;
+
+  // The checks which compare parameters are rules: the built-in ones, the
+  // ones built from the options of the filters and the ones from the
+  // "FilterRules" setting. The plan holds interned values, it is compiled
+  // again before every check so it follows the options and survives a clear
+  // of the string pool.
+  static QVector<FilterRule> builtinFilterRules();
+  QVector<FilterRule> optionFilterRules() const;
+  QVector<FilterRule> customFilterRules();
+  void compileFilterRules();
+  QVector<FilterRule> custom_filter_rules;
+  QStringList invalid_filter_rules;
+  FilterRulePlan filter_rule_plan;
+  int filter_thread_count = 0;
+
+  // The checks which are not rules, with the parameters they read. A check
+  // reading other points, like the tasks of the module, depends on the
+  // other rows as well.
+  struct NativeCheck {
+    FilterMode mode;
+    QVector<PointInfo::Parameter> columns;
+    bool other_rows;
+    void (PointsTableModel::*check)(int row,
+                                    const Point& point,
+                                    FilterMode filter_mode,
+                                    Filtering& result) const;
+  };
+  static const QVector<NativeCheck> native_checks;
+
+  // Parameters read by the rules and the native checks of a filter
+  FilterRulePlan::Dependencies filterDependencies(FilterMode mode) const;
+
+  // Checks again the filters which read the changed parameters: only the
+  // changed rows, or all the rows for the filters depending on other rows
+  void updateChangedRows(const QVector<int>& rows,
+                         const QBitArray& changed_columns);
+  void checkPoints(const QBitArray& enabled_modes, const QVector<int>& rows);
+  void checkPoint(int row,
+                  const QBitArray& enabled_modes,
+                  Filtering& result) const;
+  void checkLimits(int row,
+                   const Point& point,
+                   FilterMode filter_mode,
+                   Filtering& result) const;
+  void checkSingleModuleMultitask(int row,
+                                  const Point& point,
+                                  FilterMode filter_mode,
+                                  Filtering& result) const;
+  void checkBroadcastFrequencyTask(int row,
+                                   const Point& point,
+                                   FilterMode filter_mode,
+                                   Filtering& result) const;
+  void checkSoeInput(int row,
+                     const Point& point,
+                     FilterMode filter_mode,
+                     Filtering& result) const;
+  QSharedPointer<const PlantTopology> plant_topology;
+  // IO_TASK_INDEX values of the points of every module, by the interned
+  // DROP and IO_LOCATION of the points
+  static quint64 moduleKey(StringPool::Id drop, StringPool::Id io_location);
+  void updateModuleTasks();
+  QHash<quint64, QVector<StringPool::Id>> module_tasks;
 
 
 
@@ -0,0 +1,197 @@
+#include "pointstore.h"
+
+#include <algorithm>
+
+PointStore::PointStore() {
+  number_columns_index_.fill(-1, PointInfo::point_parameters.size());
+  int number_column_count = 0;
+  for (auto parameter : PointInfo::point_parameters) {
+    if (isNumeric(parameter)) {
+      number_columns_index_[static_cast<int>(parameter)] =
+          number_column_count++;
+    }
+  }
+  clear();
+}
+
+int PointStore::size() const {
+  return sources_.size();
+}
+
+int PointStore::addPoint(
+        const QHash<PointInfo::Parameter, QString>& parameters) {
+  auto row = sources_.size();
+  sources_.append({});
+  for (auto& column : columns_) {
+    column.append(null_value);
+  }
+  for (auto& column : number_columns_) {
+    column.append(0);
+  }
+  for (auto& valid : number_valid_) {
+    valid.resize(row + 1);
+  }
+  for (auto it = parameters.keyValueBegin();
+       it != parameters.keyValueEnd(); ++it) {
+    setValue(row, (*it).first, (*it).second);
+  }
+  const auto& appear_in_file =
+      parameters.value(PointInfo::Parameter::APPEAR_IN_FILES);
+  if (!appear_in_file.isEmpty()) {
+    addToAppearInFiles(row, appear_in_file);
+  }
+  return row;
+}
+
+void PointStore::addParameters(
+        int row,
+        const QHash<PointInfo::Parameter, QString>& parameters) {
+  auto kks = parameters.value(PointInfo::Parameter::KKS);
+  if (!kks.isEmpty() && value(row, PointInfo::Parameter::KKS) == kks) {
+    for (auto it = parameters.keyValueBegin();
+         it != parameters.keyValueEnd(); ++it) {
+      auto parameter = (*it).first;
+      if (parameter != PointInfo::Parameter::KKS) {
+        const auto& value = (*it).second;
+        if (parameter == PointInfo::Parameter::APPEAR_IN_FILES) {
+          addToAppearInFiles(row, value);
+        } else {
+          setValue(row, parameter, value);
+        }
+      }
+    }
+  }
+}
+
+const QString& PointStore::value(int row,
+                                 PointInfo::Parameter parameter) const {
+  return StringPool::instance().string(valueId(row, parameter));
+}
+
+PointStore::ValueId PointStore::valueId(int row,
+                                        PointInfo::Parameter parameter) const {
+  return columns_[static_cast<int>(parameter)][row];
+}
+
+const QString& PointStore::string(ValueId id) const {
+  return StringPool::instance().string(id);
+}
+
+float PointStore::number(int row, PointInfo::Parameter parameter) const {
+  auto index = number_columns_index_[static_cast<int>(parameter)];
+  if (index == -1) {
+    return value(row, parameter).toFloat();
+  }
+  return number_columns_[index][row];
+}
+
+bool PointStore::isNumber(int row, PointInfo::Parameter parameter) const {
+  auto index = number_columns_index_[static_cast<int>(parameter)];
+  if (index == -1) {
+    bool ok = false;
+    value(row, parameter).toFloat(&ok);
+    return ok;
+  }
+  return number_valid_[index].testBit(row);
+}
+
+bool PointStore::isNumeric(PointInfo::Parameter parameter) {
+  using P = PointInfo::Parameter;
+  switch (parameter) {
+    case P::OPERATING_RANGE_LOW:
+    case P::OPERATING_RANGE_HIGH:
+    case P::LOW_ENGINEERING_LIMIT:
+    case P::HIGH_ENGINEERING_LIMIT:
+    case P::MINIMUM_SCALE:
+    case P::MAXIMUM_SCALE:
+    case P::LOW_ALARM_LIMIT_1_VALUE:
+    case P::LOW_ALARM_LIMIT_2_VALUE:
+    case P::LOW_ALARM_LIMIT_3_VALUE:
+    case P::LOW_ALARM_LIMIT_4_VALUE:
+    case P::HIGH_ALARM_LIMIT_1_VALUE:
+    case P::HIGH_ALARM_LIMIT_2_VALUE:
+    case P::HIGH_ALARM_LIMIT_3_VALUE:
+    case P::HIGH_ALARM_LIMIT_4_VALUE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool PointStore::isInDBID(int row) const {
+  return sources_[row].is_in_dbid;
+}
+
+bool PointStore::isInSRC(int row) const {
+  return sources_[row].is_in_src;
+}
+
+bool PointStore::isInXML(int row) const {
+  return sources_[row].is_in_xml;
+}
+
+bool PointStore::isInOPHXML(int row) const {
+  return sources_[row].is_in_ophxml;
+}
+
+void PointStore::clear() {
+  columns_ = QVector<QVector<ValueId>>(PointInfo::point_parameters.size());
+  auto number_column_count =
+      std::count_if(number_columns_index_.begin(), number_columns_index_.end(),
+                    [](int index) { return index != -1; });
+  number_columns_ = QVector<QVector<float>>(number_column_count);
+  number_valid_ = QVector<QBitArray>(number_column_count);
+  sources_.clear();
+}
+
+void PointStore::setValue(int row,
+                          PointInfo::Parameter parameter,
+                          const QString& value) {
+  columns_[static_cast<int>(parameter)][row] =
+      StringPool::instance().intern(value);
+  auto index = number_columns_index_[static_cast<int>(parameter)];
+  if (index != -1) {
+    bool ok = false;
+    number_columns_[index][row] = value.toFloat(&ok);
+    number_valid_[index].setBit(row, ok);
+  }
+}
+
+void PointStore::addToAppearInFiles(int row, const QString& appear_in_file) {
+  auto& sources = sources_[row];
+  if (!sources.appear_in_files.contains(appear_in_file)) {
+    if (!sources.is_in_dbid && appear_in_file == "DBID.imp") {
+      sources.is_in_dbid = true;
+    } else if (!sources.is_in_src
+               && QStringRef(&appear_in_file, appear_in_file.length() - 3, 3)
+               == "src") {
+      sources.is_in_src = true;
+    } else if (!sources.is_in_xml
+               && QStringRef(&appear_in_file, appear_in_file.length() - 3, 3)
+               == "xml") {
+      sources.is_in_xml = true;
+    } else if (!sources.is_in_ophxml
+               && appear_in_file == "HistorianConfig.xml") {
+      sources.is_in_ophxml = true;
+    }
+
+    sources.appear_in_files.append(appear_in_file);
+    sources.appear_in_files.sort();
+    QString file_list;
+    if (sources.is_in_dbid) {
+      file_list = "DBID.imp";
+    } else {
+      file_list = "";
+    }
+    for (const auto& file : sources.appear_in_files) {
+      if (file != "DBID.imp") {
+        if (!file_list.isEmpty()) {
+          file_list += ", " + file;
+        } else {
+          file_list = file;
+        }
+      }
+    }
+    setValue(row, PointInfo::Parameter::APPEAR_IN_FILES, file_list);
+  }
+}
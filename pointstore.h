@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "point.h"
+#include "stringpool.h"
+
+// Column-oriented storage of the merged points. Every parameter has its own
+// dense column of StringPool ids indexed by row. Id 0 is a null string,
+// which is what a missing parameter reads as. The limits and scales are also
+// kept parsed in float columns.
+class PointStore {
+public:
+  using ValueId = StringPool::Id;
+  static constexpr ValueId null_value = StringPool::null_id;
+
+  PointStore();
+
+  int size() const;
+
+  int addPoint(const QHash<PointInfo::Parameter, QString>& parameters);
+  void addParameters(int row,
+                     const QHash<PointInfo::Parameter, QString>& parameters);
+
+  const QString& value(int row, PointInfo::Parameter parameter) const;
+  ValueId valueId(int row, PointInfo::Parameter parameter) const;
+  const QString& string(ValueId id) const;
+
+  // The value converted like QString::toFloat, 0 if it is not a number
+  float number(int row, PointInfo::Parameter parameter) const;
+  bool isNumber(int row, PointInfo::Parameter parameter) const;
+  static bool isNumeric(PointInfo::Parameter parameter);
+
+  bool isInDBID(int row) const;
+  bool isInSRC(int row) const;
+  bool isInXML(int row) const;
+  bool isInOPHXML(int row) const;
+
+  void clear();
+
+private:
+  struct Sources {
+    QStringList appear_in_files;
+    bool is_in_dbid = false;
+    bool is_in_src = false;
+    bool is_in_xml = false;
+    bool is_in_ophxml = false;
+  };
+
+  void setValue(int row, PointInfo::Parameter parameter, const QString& value);
+  void addToAppearInFiles(int row, const QString& appear_in_file);
+
+  QVector<QVector<ValueId>> columns_;
+  // Indexed by parameter, -1 for the parameters which are not numeric
+  QVector<int> number_columns_index_;
+  QVector<QVector<float>> number_columns_;
+  QVector<QBitArray> number_valid_;
+  QVector<Sources> sources_;
+};
@@ -0,0 +1,97 @@
+#include "srcmatcher.h"
+
+#include <cctype>
+
+SrcMatcher::SrcMatcher() {
+  for (int ch = 0; ch < 256; ++ch) {
+    first_char_[ch] = 0;
+    space_[ch] = ch == ' ' || (ch >= '\t' && ch <= '\r');
+    digit_[ch] = ch >= '0' && ch <= '9';
+  }
+
+  auto addKeyword = [this](const char* text, bool case_sensitive) -> uint {
+    auto bit = 1u << keywords_.size();
+    keywords_.append({text, case_sensitive});
+    auto first = static_cast<uchar>(text[0]);
+    first_char_[first] |= bit;
+    if (!case_sensitive) {
+      first_char_[static_cast<uchar>(std::tolower(first))] |= bit;
+      first_char_[static_cast<uchar>(std::toupper(first))] |= bit;
+    }
+    return bit;
+  };
+
+  background_mask_ = addKeyword("BACKGROUND", false);
+  for (auto text : {"FOREGROUND", "TRIGGER", "MACRO_TRIGGER", "KEYBOARD"}) {
+    background_end_mask_ |= addKeyword(text, false);
+  }
+  macro_mask_ = addKeyword("Macro", true);
+}
+
+int SrcMatcher::findBackground(const char* data, int from, int to) const {
+  return find(data, from, to, background_mask_);
+}
+
+int SrcMatcher::findBackgroundEnd(const char* data, int from, int to) const {
+  return find(data, from, to, background_end_mask_);
+}
+
+int SrcMatcher::findMacro(const char* data, int from, int to) const {
+  return find(data, from, to, macro_mask_);
+}
+
+int SrcMatcher::findMacroNumber(const char* data,
+                                int from,
+                                int to,
+                                int& number_end) const {
+  auto pos = from;
+  while (pos < to) {
+    if (!space_[static_cast<uchar>(data[pos])]) {
+      ++pos;
+      continue;
+    }
+    auto number_begin = pos;
+    while (number_begin < to && space_[static_cast<uchar>(data[number_begin])]) {
+      ++number_begin;
+    }
+    number_end = number_begin;
+    while (number_end < to && digit_[static_cast<uchar>(data[number_end])]) {
+      ++number_end;
+    }
+    if (number_end > number_begin
+        && number_end < to
+        && space_[static_cast<uchar>(data[number_end])]) {
+      return number_begin;
+    }
+    pos = number_begin;
+  }
+  return -1;
+}
+
+int SrcMatcher::find(const char* data,
+                     int from,
+                     int to,
+                     uint keyword_mask) const {
+  for (auto pos = from; pos < to; ++pos) {
+    auto candidates = first_char_[static_cast<uchar>(data[pos])] & keyword_mask;
+    for (int i = 0; candidates != 0; ++i, candidates >>= 1) {
+      if ((candidates & 1u) == 0) {
+        continue;
+      }
+      const auto& keyword = keywords_[i];
+      auto size = keyword.text.size();
+      if (pos + size > to) {
+        continue;
+      }
+      auto result = keyword.case_sensitive
+          ? qstrncmp(data + pos, keyword.text.constData(),
+                     static_cast<uint>(size))
+          : qstrnicmp(data + pos, keyword.text.constData(),
+                      static_cast<uint>(size));
+      if (result == 0) {
+        return pos;
+      }
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+// Hand-written matcher for the keywords looked up in SRC graphics files.
+// The lookup tables are built once per load and only read afterwards, so
+// one instance is shared by all SRC workers.
+class SrcMatcher {
+public:
+  SrcMatcher();
+
+  // Case insensitive "BACKGROUND"
+  int findBackground(const char* data, int from, int to) const;
+  // First of "FOREGROUND", "TRIGGER", "MACRO_TRIGGER", "KEYBOARD", case
+  // insensitive
+  int findBackgroundEnd(const char* data, int from, int to) const;
+  // Case sensitive "Macro"
+  int findMacro(const char* data, int from, int to) const;
+  // Same as the \s+(\d+)\s regular expression, returns the position of the
+  // first digit or -1
+  int findMacroNumber(const char* data,
+                      int from,
+                      int to,
+                      int& number_end) const;
+
+private:
+  struct Keyword {
+    QByteArray text;
+    bool case_sensitive;
+  };
+
+  int find(const char* data, int from, int to, uint keyword_mask) const;
+
+  QVector<Keyword> keywords_;
+  uint background_mask_ = 0;
+  uint background_end_mask_ = 0;
+  uint macro_mask_ = 0;
+
+  uint first_char_[256];
+  bool space_[256];
+  bool digit_[256];
+};
@@ -0,0 +1,94 @@
+#include "srctokenizer.h"
+
+#include <cstring>
+
+#include <QtGlobal>
+
+#include "bytescanner.h"
+
+SrcTokenizer::SrcTokenizer(const char* data, int size)
+    : data_(data), size_(size) {}
+
+bool SrcTokenizer::next(Region& region) {
+  while (pos_ < size_) {
+    auto begin = pos_;
+    if (data_[pos_] == '*') {
+      pos_ = find(pos_, '\n');
+      region = {RegionType::COMMENT, begin, pos_};
+      return true;
+    }
+
+    if (quote_ != 0) {
+      auto end = findAny(pos_, quote_, '*');
+      if (end == size_) {
+        qFatal("Not closed quotes");
+      }
+      pos_ = end;
+      if (data_[end] == quote_) {
+        quote_ = 0;
+        quote_closed_ = true;
+      }
+      if (end > begin) {
+        region = {RegionType::QUOTED, begin, end};
+        return true;
+      }
+      continue;
+    }
+
+    // The closing quote is part of the code region, it must not be taken
+    // for an opening one
+    auto from = pos_;
+    if (quote_closed_) {
+      quote_closed_ = false;
+      ++from;
+    }
+    auto end = findAny(from, '*', '"', '\'');
+    if (end < size_ && data_[end] != '*') {
+      quote_ = data_[end];
+      ++end;
+    }
+    pos_ = end;
+    if (end > begin) {
+      region = {RegionType::CODE, begin, end};
+      return true;
+    }
+  }
+  if (quote_ != 0) {
+    qFatal("Not closed quotes");
+  }
+  return false;
+}
+
+int SrcTokenizer::find(int from, char ch) const {
+  auto pos = ByteScanner::find(data_, from, size_, ch);
+  return pos != -1 ? pos : size_;
+}
+
+int SrcTokenizer::findAny(int from, char first, char second) const {
+  auto pos = ByteScanner::findAny(data_, from, size_, first, second);
+  return pos != -1 ? pos : size_;
+}
+
+int SrcTokenizer::findAny(int from,
+                          char first,
+                          char second,
+                          char third) const {
+  auto pos = ByteScanner::findAny(data_, from, size_, first, second, third);
+  return pos != -1 ? pos : size_;
+}
+
+SrcLineCounter::SrcLineCounter(const char* data) : data_(data) {}
+
+int SrcLineCounter::lineAt(int pos) {
+  if (pos < pos_) {
+    pos_ = 0;
+    line_ = 1;
+  }
+  while (auto line_end = static_cast<const char*>(
+           std::memchr(data_ + pos_, '\n', static_cast<size_t>(pos - pos_)))) {
+    ++line_;
+    pos_ = static_cast<int>(line_end - data_) + 1;
+  }
+  pos_ = pos;
+  return line_;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Splits SRC graphics source into code, comment and quoted string regions
+// in one pass without modifying the buffer. A comment starts at '*' and runs
+// to the end of the line (also inside quoted strings), quote delimiters and
+// line breaks belong to the code regions, so line numbers are preserved.
+class SrcTokenizer {
+public:
+  SrcTokenizer(const char* data, int size);
+
+  enum class RegionType {
+    CODE, COMMENT, QUOTED
+  };
+
+  struct Region {
+    RegionType type;
+    int begin;
+    int end;
+  };
+
+  bool next(Region& region);
+
+private:
+  int find(int from, char ch) const;
+  int findAny(int from, char first, char second) const;
+  int findAny(int from, char first, char second, char third) const;
+
+  const char* data_;
+  int size_;
+  int pos_ = 0;
+  char quote_ = 0;
+  bool quote_closed_ = false;
+};
+
+// Resolves buffer positions to 1-based line numbers. Positions are expected
+// in increasing order, so the buffer is scanned only once.
+class SrcLineCounter {
+public:
+  SrcLineCounter(const char* data);
+
+  int lineAt(int pos);
+
+private:
+  const char* data_;
+  int pos_ = 0;
+  int line_ = 1;
+};
@@ -0,0 +1,79 @@
+#include "stringpool.h"
+
+StringPool& StringPool::instance() {
+  static StringPool pool;
+  return pool;
+}
+
+StringPool::StringPool() {
+  chunks_[0].storeRelease(new QString[chunk_size]);
+  chunk_count_ = 1;
+  size_ = 1;
+}
+
+StringPool::~StringPool() {
+  for (int chunk = 0; chunk < chunk_count_; ++chunk) {
+    delete[] chunks_[chunk].loadAcquire();
+  }
+}
+
+StringPool::Id StringPool::intern(const QString& string) {
+  if (string.isNull()) {
+    return null_id;
+  }
+  {
+    QReadLocker locker(&lock_);
+    auto it = ids_.constFind(string);
+    if (it != ids_.constEnd()) {
+      return *it;
+    }
+  }
+  QWriteLocker locker(&lock_);
+  auto it = ids_.constFind(string);
+  if (it != ids_.constEnd()) {
+    return *it;
+  }
+  Id id = size_;
+  if ((id >> chunk_bits) == chunk_count_) {
+    if (chunk_count_ == max_chunk_count) {
+      qFatal("String pool is full");
+    }
+    chunks_[chunk_count_++].storeRelease(new QString[chunk_size]);
+  }
+  chunks_[id >> chunk_bits].loadAcquire()[id & (chunk_size - 1)] = string;
+  ids_.insert(string, id);
+  ++size_;
+  return id;
+}
+
+const QString& StringPool::internString(const QString& string) {
+  return this->string(intern(string));
+}
+
+StringPool::Id StringPool::find(const QString& string) const {
+  if (string.isNull()) {
+    return null_id;
+  }
+  QReadLocker locker(&lock_);
+  return ids_.value(string, invalid_id);
+}
+
+// The id has been handed out after its string was written, so the chunk
+// and the string are visible to the caller without locking
+const QString& StringPool::string(Id id) const {
+  return chunks_[id >> chunk_bits].loadAcquire()[id & (chunk_size - 1)];
+}
+
+int StringPool::size() const {
+  QReadLocker locker(&lock_);
+  return size_;
+}
+
+void StringPool::clear() {
+  QWriteLocker locker(&lock_);
+  for (Id id = 1; id < size_; ++id) {
+    chunks_[id >> chunk_bits].loadAcquire()[id & (chunk_size - 1)] = QString();
+  }
+  ids_.clear();
+  size_ = 1;
+}
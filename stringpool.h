@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QAtomicPointer>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+// Process-wide table of interned strings. Repeated values (KKS, drops, types,
+// file names) are stored once and referred to by compact ids, so equal
+// strings compare as equal ids. Strings are kept in fixed-size chunks which
+// never move, references returned by string() stay valid until the pool is
+// cleared and reading them takes no lock. All methods are thread-safe.
+class StringPool {
+public:
+  using Id = int;
+  static constexpr Id null_id = 0;
+  static constexpr Id invalid_id = -1;
+
+  static StringPool& instance();
+
+  Id intern(const QString& string);
+  // The pooled copy of the string, it shares the data with every other
+  // interned copy
+  const QString& internString(const QString& string);
+  // invalid_id if the string has never been interned
+  Id find(const QString& string) const;
+  const QString& string(Id id) const;
+  int size() const;
+  // Drops every string when a project is unloaded. The ids are handed out
+  // again afterwards, so a stale id reads some other string: the holders
+  // must be cleared first and nothing may read the pool during the clear,
+  // string() takes no lock. The chunks are kept.
+  void clear();
+
+private:
+  StringPool();
+  ~StringPool();
+  Q_DISABLE_COPY(StringPool)
+
+  static constexpr int chunk_bits = 14;
+  static constexpr int chunk_size = 1 << chunk_bits;
+  static constexpr int max_chunk_count = 1 << 14;
+
+  mutable QReadWriteLock lock_;
+  QAtomicPointer<QString> chunks_[max_chunk_count];
+  int chunk_count_ = 0;
+  int size_ = 0;
+  QHash<QString, Id> ids_;
+};
@@ -0,0 +1,24 @@
+# Checks the ByteScanner kernels against a plain loop on random inputs and
+# times them against QString::indexOf on synthetic graphics and logic files
+
+QT       += core testlib
+QT       -= gui
+
+TARGET = tst_bytescanner
+TEMPLATE = app
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+QMAKE_CXXFLAGS += -std=c++17
+
+NEXUS_DIR = $$PWD/../..
+INCLUDEPATH += $$NEXUS_DIR
+
+SOURCES += \
+    tst_bytescanner.cpp \
+    $$NEXUS_DIR/bytescanner.cpp
+
+HEADERS += \
+    $$NEXUS_DIR/bytescanner.h
@@ -0,0 +1,160 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <random>
+
+#include "bytescanner.h"
+
+namespace {
+
+  int plainFind(const char* data, int from, int to, const QByteArray& any) {
+    for (auto pos = from; pos < to; ++pos) {
+      if (any.contains(data[pos])) {
+        return pos;
+      }
+    }
+    return -1;
+  }
+
+  int plainFind(const char* data,
+                int from,
+                int to,
+                const char* text,
+                int size) {
+    for (auto pos = from; pos <= to - size; ++pos) {
+      if (std::equal(text, text + size, data + pos)) {
+        return pos;
+      }
+    }
+    return -1;
+  }
+
+  // Few distinct bytes, so the needles are found at every offset of the
+  // vector blocks, and long enough for several AVX2 blocks
+  QByteArray randomBytes(std::mt19937& random) {
+    static const char alphabet[] = "ab\\\"=pointxyz\n";
+    std::uniform_int_distribution<int> size(0, 300);
+    std::uniform_int_distribution<int> byte(0, sizeof(alphabet) - 2);
+    QByteArray bytes;
+    for (int i = size(random); i > 0; --i) {
+      bytes += alphabet[byte(random)];
+    }
+    return bytes;
+  }
+
+  // Graphics files have the KKS between backslashes, logic files in the
+  // point attributes. Every line but one in 8 is text without a KKS.
+  QByteArray syntheticCorpus(const QString& kind, int kks_count) {
+    QByteArray corpus;
+    for (int i = 0; i < kks_count; ++i) {
+      auto kks = QString("10LAB%1CP%2XQ01").arg(i % 97).arg(i % 1000);
+      if (kind == "graphics") {
+        corpus += QString("  Macro %1 \\%2\\ 120 340 0 1\n")
+            .arg(i % 900 + 100).arg(kks).toLatin1();
+      } else {
+        corpus += QString("  <input name=\"IN%1\" point=\"%2\" />\n")
+            .arg(i % 16).arg(kks).toLatin1();
+      }
+      for (int line = 0; line < 7; ++line) {
+        corpus += "  <line x1=\"10\" y1=\"20\" x2=\"30\" y2=\"40\" "
+                  "color=\"7\" width=\"1\" style=\"solid\" />\n";
+      }
+    }
+    return corpus;
+  }
+
+}
+
+class ByteScannerTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void findMatchesPlainLoop();
+  void indexOfBenchmark_data();
+  void indexOfBenchmark();
+  void byteScannerBenchmark_data();
+  void byteScannerBenchmark();
+};
+
+void ByteScannerTest::findMatchesPlainLoop() {
+  std::mt19937 random(1);
+  for (int i = 0; i < 20000; ++i) {
+    auto bytes = randomBytes(random);
+    auto data = bytes.constData();
+    std::uniform_int_distribution<int> position(0, bytes.size());
+    auto from = position(random);
+    auto to = std::max(from, position(random));
+
+    QCOMPARE(ByteScanner::find(data, from, to, '\\'),
+             plainFind(data, from, to, QByteArray("\\")));
+    QCOMPARE(ByteScanner::findAny(data, from, to, '\\', '"'),
+             plainFind(data, from, to, QByteArray("\\\"")));
+    QCOMPARE(ByteScanner::findAny(data, from, to, '\\', '"', '\n'),
+             plainFind(data, from, to, QByteArray("\\\"\n")));
+    const char text[] = R"(point=")";
+    const int text_size = sizeof(text) - 1;
+    QCOMPARE(ByteScanner::find(data, from, to, text, text_size),
+             plainFind(data, from, to, text, text_size));
+  }
+}
+
+void ByteScannerTest::indexOfBenchmark_data() {
+  QTest::addColumn<QByteArray>("corpus");
+  QTest::addColumn<QByteArray>("delimiter");
+  QTest::addColumn<int>("expected_count");
+
+  QTest::newRow("graphics") << syntheticCorpus("graphics", 20000)
+                            << QByteArray("\\") << 40000;
+  QTest::newRow("logic") << syntheticCorpus("logic", 20000)
+                         << QByteArray(R"(point=")") << 20000;
+}
+
+// The files used to be decoded to UTF-16 and searched with indexOf, the
+// decoding is not timed
+void ByteScannerTest::indexOfBenchmark() {
+  QFETCH(QByteArray, corpus);
+  QFETCH(QByteArray, delimiter);
+  QFETCH(int, expected_count);
+
+  auto content = QString::fromLatin1(corpus);
+  auto search_text = QString::fromLatin1(delimiter);
+  int count = 0;
+  QBENCHMARK {
+    count = 0;
+    auto pos = content.indexOf(search_text);
+    while (pos != -1) {
+      ++count;
+      pos = content.indexOf(search_text, pos + search_text.size());
+    }
+  }
+  QCOMPARE(count, expected_count);
+}
+
+void ByteScannerTest::byteScannerBenchmark_data() {
+  indexOfBenchmark_data();
+}
+
+void ByteScannerTest::byteScannerBenchmark() {
+  QFETCH(QByteArray, corpus);
+  QFETCH(QByteArray, delimiter);
+  QFETCH(int, expected_count);
+
+  auto data = corpus.constData();
+  auto size = corpus.size();
+  int count = 0;
+  QBENCHMARK {
+    count = 0;
+    auto pos = ByteScanner::find(data, 0, size,
+                                 delimiter.constData(), delimiter.size());
+    while (pos != -1) {
+      ++count;
+      pos = ByteScanner::find(data, pos + delimiter.size(), size,
+                              delimiter.constData(), delimiter.size());
+    }
+  }
+  QCOMPARE(count, expected_count);
+}
+
+QTEST_APPLESS_MAIN(ByteScannerTest)
+
+#include "tst_bytescanner.moc"
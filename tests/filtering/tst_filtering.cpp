@@ -0,0 +1,308 @@
+#include <QtTest>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "globalsettings.h"
+#include "pointstablemodel.h"
+
+QJsonObject global_settings;
+
+namespace {
+
+  using P = PointInfo::Parameter;
+  using Container = QVector<QHash<P, QString>>;
+
+  // Points reported by every filter: XQ02 points with their XQ01 points,
+  // mismatching scales, limits and priorities, characteristics, several
+  // tasks in one module and SOE points. The values follow the row number,
+  // so every run checks the same points.
+  Container syntheticPoints(int count) {
+    const QVector<PointInfo::Type> types = {
+      PointInfo::Type::AnalogPoint,
+      PointInfo::Type::DigitalPoint,
+      PointInfo::Type::PackedPoint,
+      PointInfo::Type::AnalogPoint,
+      PointInfo::Type::DigitalPoint,
+      PointInfo::Type::ModulePoint
+    };
+    Container points;
+    for (int i = 0; i < count; ++i) {
+      QHash<P, QString> point;
+      auto pair = i / 2;
+      auto suffix = i % 2 ? "XQ01" : "_XQ02";
+      point[P::KKS] =
+          QString("10LAB%1CP%2").arg(pair % 97).arg(pair) + suffix;
+      point[P::TYPE] = PointInfo::toString(types[pair % types.size()]);
+      point[P::DROP] = QString("DROP%1").arg(pair % 7);
+      point[P::IO_LOCATION] = QString::number(pair % 13 + 1);
+      point[P::IO_CHANNEL] = QString::number(pair % 16 + 1);
+      point[P::IO_TASK_INDEX] = QString::number(i % 11 == 0 ? 2 : 1);
+      point[P::BROADCAST_FREQUENCY] = i % 3 ? "S" : "F";
+      point[P::APPEAR_IN_FILES] = i % 5 ? "DBID.imp" : "a.src";
+      if (i % 4) {
+        point[P::CHARACTERISTICS] = QString("%1-----%2")
+            .arg(QChar('A' + i % 26))
+            .arg(i % 100, 2, 10, QChar('0'));
+      }
+      point[P::OPERATING_RANGE_LOW] = QString::number(i % 9 ? 0 : 10);
+      point[P::OPERATING_RANGE_HIGH] = QString::number(100 + i % 3);
+      if (i % 6) {
+        point[P::LOW_ENGINEERING_LIMIT] = point[P::OPERATING_RANGE_LOW];
+        point[P::MINIMUM_SCALE] = QString::number(i % 8 ? 0 : 5);
+      }
+      point[P::HIGH_ENGINEERING_LIMIT] = point[P::OPERATING_RANGE_HIGH];
+      point[P::MAXIMUM_SCALE] = "100";
+      point[P::LOW_ALARM_LIMIT_1_TYPE] = i % 10 == 1 ? "" : "V";
+      if (i % 12) {
+        point[P::LOW_ALARM_LIMIT_1_VALUE] = QString::number(i % 20);
+      }
+      point[P::HIGH_ALARM_LIMIT_1_TYPE] = "V";
+      point[P::HIGH_ALARM_LIMIT_1_VALUE] = QString::number(90 + i % 20);
+      point[P::LOW_ALARM_PRIORITY_1] = QString::number(i % 4);
+      point[P::HIGH_ALARM_PRIORITY_3] = QString::number(i % 3);
+      point[P::SOE_POINT] = QString::number(i % 2);
+      point[P::SOE_ENABLED] = QString::number(i % 7 == 0 ? 1 - i % 2 : i % 2);
+      if (i % 2 == 0) {
+        point[P::ANC_5] = point[P::DROP].mid(4);
+        point[P::ANC_6] = QString::number(pair % 13 + (i % 17 == 0 ? 2 : 1));
+        point[P::ANC_7] = point[P::IO_CHANNEL];
+      }
+      points.append(point);
+    }
+    return points;
+  }
+
+  // Changes the parameters of some of the points, like a second source does
+  Container changedPoints(const Container& points) {
+    Container changed;
+    for (int i = 0; i < points.size(); i += 3) {
+      QHash<P, QString> point;
+      point[P::KKS] = points[i][P::KKS];
+      point[P::APPEAR_IN_FILES] = "b.xml";
+      point[P::IO_TASK_INDEX] = QString::number(i % 5 == 0 ? 3 : 1);
+      point[P::MAXIMUM_SCALE] = QString::number(100 + i % 2);
+      changed.append(point);
+    }
+    return changed;
+  }
+
+  int findRow(const PointsTableModel& model, const QString& kks) {
+    const auto& point_store = model.pointStore();
+    for (int row = 0; row < point_store.size(); ++row) {
+      if (point_store.value(row, P::KKS) == kks) {
+        return row;
+      }
+    }
+    return -1;
+  }
+
+  void compareFiltering(const PointsTableModel& expected,
+                        const PointsTableModel& actual) {
+    QCOMPARE(actual.rowCount(), expected.rowCount());
+    for (const auto& filter_info : PointsTableModel::filters) {
+      auto mode = filter_info.mode;
+      for (int row = 0; row < expected.rowCount(); ++row) {
+        QCOMPARE(actual.filtering.hasError(row, mode),
+                 expected.filtering.hasError(row, mode));
+        QCOMPARE(actual.filtering.getErrorInfo(row, mode),
+                 expected.filtering.getErrorInfo(row, mode));
+        for (auto parameter : PointInfo::point_parameters) {
+          QCOMPARE(actual.filtering.getErrorColor(row, mode, parameter),
+                   expected.filtering.getErrorColor(row, mode, parameter));
+        }
+      }
+    }
+  }
+
+}
+
+class FilteringTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void handBuiltPoints_data();
+  void handBuiltPoints();
+  void parallelMatchesSerial_data();
+  void parallelMatchesSerial();
+  void changedRowsMatchFullCheck();
+  void filterThreadScaling_data();
+  void filterThreadScaling();
+};
+
+void FilteringTest::initTestCase() {
+  // A custom rule linking the points, read by the constructor of the model
+  global_settings["FilterRules"] = QJsonArray{
+    QJsonDocument::fromJson(R"({
+      "mode": "ANCILLARY_ERRORS",
+      "conditions": [["link.TYPE", "!=", "@TYPE"]],
+      "link": [["_XQ02", "XQ01"]],
+      "message": "{TYPE} != {link.TYPE}",
+      "errors": ["TYPE"]
+    })").object()
+  };
+}
+
+void FilteringTest::handBuiltPoints_data() {
+  QTest::addColumn<int>("thread_count");
+
+  QTest::newRow("serial") << 1;
+  QTest::newRow("chunks") << 4;
+}
+
+// A few points with known errors among points without errors, spread over
+// several chunks
+void FilteringTest::handBuiltPoints() {
+  QFETCH(int, thread_count);
+
+  Container points;
+  for (int i = 0; i < 1000; ++i) {
+    QHash<P, QString> point;
+    point[P::KKS] = QString("10FILL%1").arg(i);
+    point[P::TYPE] = PointInfo::toString(PointInfo::Type::AnalogPoint);
+    point[P::DROP] = "DROP90";
+    point[P::IO_LOCATION] = "1";
+    point[P::IO_TASK_INDEX] = "1";
+    points.append(point);
+  }
+  auto& limits = points[300];
+  limits[P::KKS] = "10LIMITS";
+  limits[P::OPERATING_RANGE_LOW] = "0";
+  limits[P::OPERATING_RANGE_HIGH] = "100";
+  limits[P::LOW_ALARM_LIMIT_1_TYPE] = "V";
+  limits[P::HIGH_ALARM_LIMIT_1_TYPE] = "V";
+  limits[P::HIGH_ALARM_LIMIT_1_VALUE] = "120";
+  for (auto [i, location, task] : QList<std::tuple<int, QString, QString>>{
+         {500, "2", "1"}, {900, "2", "2"}, {700, "3", "2"}}) {
+    auto& point = points[i];
+    point[P::KKS] = QString("10TASK%1").arg(i);
+    point[P::DROP] = "DROP91";
+    point[P::IO_LOCATION] = location;
+    point[P::IO_TASK_INDEX] = task;
+  }
+
+  PointsTableModel model;
+  model.setFilterThreadCount(thread_count);
+  model.loadPoints(points);
+
+  const auto limits_mode = PointsTableModel::FilterMode::LIMITS_ERRORS;
+  auto limits_row = findRow(model, "10LIMITS");
+  QVERIFY(limits_row != -1);
+  QCOMPARE(model.filtering.getErrorInfo(limits_row, limits_mode),
+           QStringList({
+             "LOW_ALARM_LIMIT_1_TYPE = \"V\", но значение "
+             "LOW_ALARM_LIMIT_1_VALUE отсутствует",
+             "HIGH_ALARM_LIMIT_1_VALUE выше чем OPERATING_RANGE_HIGH",
+             "120 > 100"
+           }));
+  QCOMPARE(model.filtering.getErrorColor(limits_row, limits_mode,
+                                         P::LOW_ALARM_LIMIT_1_VALUE),
+           QColor(Qt::GlobalColor::gray));
+  QCOMPARE(model.filtering.getErrorColor(limits_row, limits_mode,
+                                         P::HIGH_ALARM_LIMIT_1_VALUE),
+           QColor(Qt::GlobalColor::red));
+  QVERIFY(!model.filtering.getErrorColor(limits_row, limits_mode, P::KKS)
+           .isValid());
+
+  const auto task_mode =
+      PointsTableModel::FilterMode::SINGLE_MODULE_MULTITASK_ERRORS;
+  const QStringList task_error = {
+    "Точка находится в модуле (DROP91 2), в котором находятся точки в "
+    "разных тасках"
+  };
+  QCOMPARE(model.filtering.getErrorInfo(findRow(model, "10TASK500"),
+                                        task_mode),
+           task_error);
+  QCOMPARE(model.filtering.getErrorInfo(findRow(model, "10TASK900"),
+                                        task_mode),
+           task_error);
+  QVERIFY(!model.filtering.hasError(findRow(model, "10TASK700"), task_mode));
+
+  for (int row = 0; row < model.rowCount(); ++row) {
+    if (row != limits_row) {
+      QVERIFY(!model.filtering.hasError(row, limits_mode));
+    }
+  }
+}
+
+void FilteringTest::parallelMatchesSerial_data() {
+  QTest::addColumn<int>("point_count");
+  QTest::addColumn<int>("thread_count");
+
+  QTest::newRow("one chunk") << 200 << 4;
+  QTest::newRow("chunks") << 10000 << 4;
+  QTest::newRow("more threads than chunks") << 3000 << 16;
+}
+
+void FilteringTest::parallelMatchesSerial() {
+  QFETCH(int, point_count);
+  QFETCH(int, thread_count);
+
+  auto points = syntheticPoints(point_count);
+
+  // The serial model checks straight into its results, the parallel one
+  // checks chunks and merges them
+  PointsTableModel serial;
+  QVERIFY(serial.invalidFilterRules().isEmpty());
+  serial.setFilterThreadCount(1);
+  serial.loadPoints(points);
+
+  PointsTableModel parallel;
+  parallel.setFilterThreadCount(thread_count);
+  parallel.loadPoints(points);
+
+  compareFiltering(serial, parallel);
+  if (QTest::currentTestFailed()) {
+    return;
+  }
+
+  serial.updateFiltering();
+  parallel.updateFiltering();
+  compareFiltering(serial, parallel);
+}
+
+// Only the filters reading the changed parameters are checked again, the
+// results must be the ones of a check of every point
+void FilteringTest::changedRowsMatchFullCheck() {
+  auto points = syntheticPoints(5000);
+  auto changed = changedPoints(points);
+
+  PointsTableModel full;
+  full.setFilterThreadCount(1);
+  full.loadPoints(points);
+  full.loadPoints(changed);
+  full.updateFiltering();
+
+  PointsTableModel incremental;
+  incremental.loadPoints(points);
+  incremental.loadPoints(changed);
+
+  compareFiltering(full, incremental);
+}
+
+void FilteringTest::filterThreadScaling_data() {
+  QTest::addColumn<int>("thread_count");
+
+  for (auto thread_count : {1, 2, 4, 8, 16}) {
+    QTest::newRow(qPrintable(QString("%1 threads").arg(thread_count)))
+        << thread_count;
+  }
+}
+
+// Time of a check of all the points, compared between the thread counts
+void FilteringTest::filterThreadScaling() {
+  QFETCH(int, thread_count);
+
+  PointsTableModel model;
+  model.setFilterThreadCount(thread_count);
+  model.loadPoints(syntheticPoints(200000));
+  QBENCHMARK {
+    model.updateFiltering();
+  }
+}
+
+QTEST_MAIN(FilteringTest)
+
+#include "tst_filtering.moc"
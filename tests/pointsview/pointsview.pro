@@ -0,0 +1,55 @@
+# Checks the column to parameter mapping of PointsTableModel and times the
+# reading and painting of the cells while scrolling over 500k rows
+
+QT       += core gui widgets concurrent testlib
+
+TARGET = tst_pointsview
+TEMPLATE = app
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+QMAKE_CXXFLAGS += -std=c++17
+
+NEXUS_DIR = $$PWD/../..
+INCLUDEPATH += $$NEXUS_DIR
+
+SOURCES += \
+    tst_pointsview.cpp \
+    $$NEXUS_DIR/point.cpp \
+    $$NEXUS_DIR/pointstore.cpp \
+    $$NEXUS_DIR/stringpool.cpp \
+    $$NEXUS_DIR/loader.cpp \
+    $$NEXUS_DIR/bytescanner.cpp \
+    $$NEXUS_DIR/mappedfile.cpp \
+    $$NEXUS_DIR/dbidparser.cpp \
+    $$NEXUS_DIR/dbidtree.cpp \
+    $$NEXUS_DIR/planttopology.cpp \
+    $$NEXUS_DIR/srctokenizer.cpp \
+    $$NEXUS_DIR/srcmatcher.cpp \
+    $$NEXUS_DIR/filterrule.cpp \
+    $$NEXUS_DIR/wildcardmask.cpp \
+    $$NEXUS_DIR/kksindex.cpp \
+    $$NEXUS_DIR/pointstablemodel.cpp \
+    $$NEXUS_DIR/srcbgproxymodel.cpp
+
+HEADERS += \
+    $$NEXUS_DIR/threadrunner.h \
+    $$NEXUS_DIR/point.h \
+    $$NEXUS_DIR/pointstore.h \
+    $$NEXUS_DIR/stringpool.h \
+    $$NEXUS_DIR/loader.h \
+    $$NEXUS_DIR/bytescanner.h \
+    $$NEXUS_DIR/mappedfile.h \
+    $$NEXUS_DIR/dbidparser.h \
+    $$NEXUS_DIR/dbidtree.h \
+    $$NEXUS_DIR/planttopology.h \
+    $$NEXUS_DIR/srctokenizer.h \
+    $$NEXUS_DIR/srcmatcher.h \
+    $$NEXUS_DIR/filterrule.h \
+    $$NEXUS_DIR/wildcardmask.h \
+    $$NEXUS_DIR/kksindex.h \
+    $$NEXUS_DIR/pointstablemodel.h \
+    $$NEXUS_DIR/srcbgproxymodel.h \
+    $$NEXUS_DIR/globalsettings.h
@@ -0,0 +1,111 @@
+#include <QtTest>
+
+#include <QImage>
+#include <QJsonObject>
+#include <QTableView>
+
+#include "globalsettings.h"
+#include "pointstablemodel.h"
+
+QJsonObject global_settings;
+
+namespace {
+
+  using P = PointInfo::Parameter;
+  using Container = QVector<QHash<P, QString>>;
+
+  const int point_count = 500000;
+
+  // Half of the parameters are set, the other cells are painted as missing
+  Container syntheticPoints(int count) {
+    Container points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+      QHash<P, QString> point;
+      for (int column = 0; column < PointInfo::point_parameters.size();
+           column += 2) {
+        point[PointInfo::point_parameters[column]] =
+            QString("V%1.%2").arg(i % 1000).arg(column);
+      }
+      point[P::KKS] = QString("10LAB%1CP%2XQ01").arg(i % 97).arg(i);
+      point[P::TYPE] = PointInfo::toString(PointInfo::Type::AnalogPoint);
+      points.append(point);
+    }
+    return points;
+  }
+
+}
+
+// Run with -platform offscreen where there is no display
+class PointsViewTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void columnsMatchParameters();
+  void dataBenchmark();
+  void paintBenchmark();
+
+private:
+  Container points;
+  PointsTableModel model;
+};
+
+void PointsViewTest::initTestCase() {
+  points = syntheticPoints(point_count);
+  model.loadPoints(points);
+  QCOMPARE(model.rowCount(), point_count);
+}
+
+// The column used to be resolved from the header text through QMetaEnum
+void PointsViewTest::columnsMatchParameters() {
+  for (int column = 0; column < model.columnCount(); ++column) {
+    auto parameter = PointInfo::parameterFromString(
+          model.headerData(column, Qt::Horizontal).toString());
+    QCOMPARE(parameter, PointInfo::point_parameters[column]);
+    for (auto row : {0, 1, point_count / 2, point_count - 1}) {
+      auto index = model.index(row, column);
+      auto value = points[row].value(parameter);
+      QCOMPARE(model.data(index).toString(), value);
+      QCOMPARE(model.data(index, Qt::ForegroundRole).isValid(),
+               value.isNull());
+    }
+  }
+}
+
+// The cells a view reads while it is scrolled over all the rows, a page of
+// rows every 1000 rows
+void PointsViewTest::dataBenchmark() {
+  const int page_size = 40;
+  int text_size = 0;
+  QBENCHMARK {
+    text_size = 0;
+    for (int first_row = 0; first_row < point_count; first_row += 1000) {
+      for (int row = first_row; row < first_row + page_size; ++row) {
+        for (int column = 0; column < model.columnCount(); ++column) {
+          auto index = model.index(row, column);
+          text_size += model.data(index).toString().size();
+          model.data(index, Qt::ForegroundRole);
+        }
+      }
+    }
+  }
+  QVERIFY(text_size > 0);
+}
+
+void PointsViewTest::paintBenchmark() {
+  QTableView view;
+  view.setModel(&model);
+  view.resize(1600, 900);
+  QImage image(view.size(), QImage::Format_ARGB32_Premultiplied);
+  QBENCHMARK {
+    for (int row = 0; row < point_count; row += point_count / 50) {
+      view.scrollTo(model.index(row, 0), QAbstractItemView::PositionAtTop);
+      view.render(&image);
+    }
+  }
+}
+
+QTEST_MAIN(PointsViewTest)
+
+#include "tst_pointsview.moc"
@@ -0,0 +1,24 @@
+# Checks SrcMatcher against a plain keyword search and std::regex on random
+# inputs and times it against the regular expression scan it replaced
+
+QT       += core testlib
+QT       -= gui
+
+TARGET = tst_srcmatcher
+TEMPLATE = app
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+QMAKE_CXXFLAGS += -std=c++17
+
+NEXUS_DIR = $$PWD/../..
+INCLUDEPATH += $$NEXUS_DIR
+
+SOURCES += \
+    tst_srcmatcher.cpp \
+    $$NEXUS_DIR/srcmatcher.cpp
+
+HEADERS += \
+    $$NEXUS_DIR/srcmatcher.h
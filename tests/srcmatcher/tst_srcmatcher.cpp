@@ -0,0 +1,221 @@
+#include <QtTest>
+
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <regex>
+
+#include "srcmatcher.h"
+
+namespace {
+
+  const char* background_end_keywords[] = {
+    "FOREGROUND", "TRIGGER", "MACRO_TRIGGER", "KEYBOARD"
+  };
+
+  // The keyword search SrcMatcher replaced
+  int plainFind(const char* data,
+                int from,
+                int to,
+                const char* text,
+                Qt::CaseSensitivity cs) {
+    auto text_size = static_cast<int>(qstrlen(text));
+    for (auto pos = from; pos <= to - text_size; ++pos) {
+      auto result = cs == Qt::CaseSensitive
+          ? qstrncmp(data + pos, text, static_cast<uint>(text_size))
+          : qstrnicmp(data + pos, text, static_cast<uint>(text_size));
+      if (result == 0) {
+        return pos;
+      }
+    }
+    return -1;
+  }
+
+  // Keywords in several cases, their prefixes, numbers and white space
+  QByteArray randomText(std::mt19937& random) {
+    static const char* pieces[] = {
+      "BACKGROUND", "background", "BackGrounD", "BACKGROUN", "FOREGROUND",
+      "Trigger", "MACRO_TRIGGER", "KEYBOARD", "keyboarD", "Macro", "macro",
+      "MACRO", "Macr", " ", "  ", "\t", "\n", "\r\n", "\v", "1", "42", "007",
+      "a", "Z", "_", "-", "\\"
+    };
+    std::uniform_int_distribution<int> piece_count(0, 60);
+    std::uniform_int_distribution<int> piece(
+          0, static_cast<int>(std::size(pieces)) - 1);
+    QByteArray text;
+    for (int i = piece_count(random); i > 0; --i) {
+      text += pieces[piece(random)];
+    }
+    return text;
+  }
+
+  // A graphics file with Macro calls in its background section and after it
+  QByteArray syntheticSrc(int macro_count) {
+    QByteArray src = "DIAGRAM 10LAB00\n  SIZE 1920 1080\nBACKGROUND\n";
+    for (int i = 0; i < macro_count; ++i) {
+      src += QString("  Macro %1 \\10LAB%2CP001XQ01\\ 120 340 0 1\n")
+          .arg(i % 900 + 100).arg(i % 97).toLatin1();
+      for (int line = 0; line < 3; ++line) {
+        src += "  LINE 10 20 30 40 COLOR 7 WIDTH 1 STYLE SOLID\n";
+      }
+    }
+    src += "FOREGROUND\n";
+    for (int i = 0; i < macro_count / 3; ++i) {
+      src += QString("  Macro %1 \\10LBA%2CF001XQ01\\ 20 40 0 1\n")
+          .arg(i).arg(i % 31).toLatin1();
+    }
+    return src;
+  }
+
+  // The background scan as it was: the keywords are searched one by one and
+  // a regular expression is compiled for every Macro
+  QStringList regexScan(const QByteArray& src) {
+    auto data = src.constData();
+    auto size = src.size();
+    QStringList numbers;
+    auto begin = plainFind(data, 0, size, "BACKGROUND", Qt::CaseInsensitive);
+    if (begin == -1) {
+      return numbers;
+    }
+    auto end = size;
+    for (auto keyword : background_end_keywords) {
+      auto pos = plainFind(data, begin, size, keyword, Qt::CaseInsensitive);
+      if (pos != -1 && pos < end) {
+        end = pos;
+      }
+    }
+    auto macro_pos = plainFind(data, begin, size, "Macro", Qt::CaseSensitive);
+    while (macro_pos != -1 && macro_pos < end) {
+      QRegularExpression re("\\s+(\\d+)\\s");
+      auto number_pos = macro_pos + static_cast<int>(qstrlen("Macro"));
+      numbers.append(re.match(
+                       QString::fromLatin1(data + number_pos,
+                                           std::min(size - number_pos, 64)))
+                     .captured(1));
+      macro_pos = plainFind(data, macro_pos + 1, size,
+                            "Macro", Qt::CaseSensitive);
+    }
+    return numbers;
+  }
+
+  QStringList matcherScan(const SrcMatcher& matcher, const QByteArray& src) {
+    auto data = src.constData();
+    auto size = src.size();
+    QStringList numbers;
+    auto begin = matcher.findBackground(data, 0, size);
+    if (begin == -1) {
+      return numbers;
+    }
+    auto end = matcher.findBackgroundEnd(data, begin, size);
+    if (end == -1) {
+      end = size;
+    }
+    auto macro_pos = matcher.findMacro(data, begin, size);
+    while (macro_pos != -1 && macro_pos < end) {
+      auto number_pos = macro_pos + static_cast<int>(qstrlen("Macro"));
+      int number_end;
+      auto number_begin = matcher.findMacroNumber(
+            data, number_pos, std::min(size, number_pos + 64), number_end);
+      numbers.append(number_begin != -1
+                     ? QString::fromLatin1(data + number_begin,
+                                           number_end - number_begin)
+                     : QString());
+      macro_pos = matcher.findMacro(data, macro_pos + 1, size);
+    }
+    return numbers;
+  }
+
+}
+
+class SrcMatcherTest : public QObject {
+  Q_OBJECT
+
+private slots:
+  void keywordsMatchPlainSearch();
+  void macroNumberMatchesRegex();
+  void scanMatchesRegexScan();
+  void regexScanBenchmark();
+  void matcherScanBenchmark();
+
+private:
+  SrcMatcher matcher;
+};
+
+void SrcMatcherTest::keywordsMatchPlainSearch() {
+  std::mt19937 random(1);
+  for (int i = 0; i < 5000; ++i) {
+    auto text = randomText(random);
+    auto data = text.constData();
+    std::uniform_int_distribution<int> position(0, text.size());
+    auto from = position(random);
+    auto to = std::max(from, position(random));
+
+    QCOMPARE(matcher.findBackground(data, from, to),
+             plainFind(data, from, to, "BACKGROUND", Qt::CaseInsensitive));
+    auto end = -1;
+    for (auto keyword : background_end_keywords) {
+      auto pos = plainFind(data, from, to, keyword, Qt::CaseInsensitive);
+      if (pos != -1 && (end == -1 || pos < end)) {
+        end = pos;
+      }
+    }
+    QCOMPARE(matcher.findBackgroundEnd(data, from, to), end);
+    QCOMPARE(matcher.findMacro(data, from, to),
+             plainFind(data, from, to, "Macro", Qt::CaseSensitive));
+  }
+}
+
+void SrcMatcherTest::macroNumberMatchesRegex() {
+  const std::regex re(R"(\s+(\d+)\s)");
+  std::mt19937 random(2);
+  for (int i = 0; i < 5000; ++i) {
+    auto text = randomText(random);
+    auto data = text.constData();
+    std::uniform_int_distribution<int> position(0, text.size());
+    auto from = position(random);
+    auto to = std::max(from, position(random));
+
+    int number_end = -1;
+    auto number_begin = matcher.findMacroNumber(data, from, to, number_end);
+    std::cmatch match;
+    if (std::regex_search(data + from, data + to, match, re)) {
+      QCOMPARE(number_begin, from + static_cast<int>(match.position(1)));
+      QCOMPARE(number_end, number_begin + static_cast<int>(match.length(1)));
+    } else {
+      QCOMPARE(number_begin, -1);
+    }
+  }
+}
+
+void SrcMatcherTest::scanMatchesRegexScan() {
+  auto src = syntheticSrc(300);
+  auto numbers = matcherScan(matcher, src);
+  QCOMPARE(numbers.size(), 300);
+  QCOMPARE(numbers, regexScan(src));
+}
+
+// The two benchmarks scan the same file, the matcher is built once per load
+// and is not timed
+void SrcMatcherTest::regexScanBenchmark() {
+  auto src = syntheticSrc(3000);
+  QStringList numbers;
+  QBENCHMARK {
+    numbers = regexScan(src);
+  }
+  QCOMPARE(numbers.size(), 3000);
+}
+
+void SrcMatcherTest::matcherScanBenchmark() {
+  auto src = syntheticSrc(3000);
+  QStringList numbers;
+  QBENCHMARK {
+    numbers = matcherScan(matcher, src);
+  }
+  QCOMPARE(numbers.size(), 3000);
+}
+
+QTEST_APPLESS_MAIN(SrcMatcherTest)
+
+#include "tst_srcmatcher.moc"
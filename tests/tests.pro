@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bytescanner \
+    filtering \
+    pointsview \
+    srcmatcher
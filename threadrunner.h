@@ -1,45 +1,159 @@
 #pragma once
 
-#include <QObject>
-#include <QThread>
+#include <functional>
+#include <type_traits>
 
+#include <QAtomicInt>
+#include <QFutureSynchronizer>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
 
 namespace ThreadRunner {
 
-  template <class T>
-  std::decay_t<T> decay_copy(T&& v) { return std::forward<T>(v); }
+  enum class Priority {
+    LOW, NORMAL, HIGH
+  };
+
+  // Copies of a token share the same flag. The work polls the token and
+  // stops early once it is cancelled.
+  class CancellationToken {
+  public:
+    CancellationToken() : cancelled(QSharedPointer<QAtomicInt>::create(0)) {}
+
+    void cancel() const { cancelled->storeRelease(1); }
+    bool isCancelled() const { return cancelled->loadAcquire() != 0; }
 
-  class ThreadWorker : public QObject {
-    Q_OBJECT
+  private:
+    QSharedPointer<QAtomicInt> cancelled;
+  };
+
+  template<class T>
+  class TaskState {
   public:
-    ThreadWorker(QObject* parent = nullptr) : QObject(parent) {}
+    // void results are stored as a dummy value to keep one code path
+    using Value = std::conditional_t<std::is_void_v<T>, std::nullptr_t, T>;
+
+    void finish(Value result) {
+      QVector<std::function<void ()>> ready_continuations;
+      {
+        QMutexLocker locker(&mutex);
+        value = std::move(result);
+        done = true;
+        ready_continuations.swap(continuations);
+      }
+      for (const auto& continuation : ready_continuations) {
+        continuation();
+      }
+    }
+
+    void onFinished(const std::function<void ()>& continuation) {
+      {
+        QMutexLocker locker(&mutex);
+        if (!done) {
+          continuations.append(continuation);
+          return;
+        }
+      }
+      continuation();
+    }
 
+    // Only called once the task has finished
+    Value result() {
+      QMutexLocker locker(&mutex);
+      return value;
+    }
+
+  private:
+    QMutex mutex;
+    bool done = false;
+    Value value{};
+    QVector<std::function<void ()>> continuations;
+  };
+
+  // Handle of a task started by run(). then() delivers the result to the
+  // thread of the context object, usually the GUI thread.
+  template<class T>
+  class Task {
   public:
+    explicit Task(const QSharedPointer<TaskState<T>>& state) : state(state) {}
+
+    // The continuation is skipped if the context has been destroyed
     template<class Function>
-    void run(Function&& f) {
-      std::invoke(decay_copy(std::forward<Function>(f)));
-      emit finished();
+    void then(QObject* context, Function&& continuation) const {
+      QPointer<QObject> guard(context);
+      auto task_state = state;
+      std::function<void ()> deliver =
+          [guard, task_state,
+           continuation = std::forward<Function>(continuation)]() {
+        if (guard.isNull()) {
+          return;
+        }
+        QMetaObject::invokeMethod(guard, [task_state, continuation]() {
+          if constexpr (std::is_void_v<T>) {
+            continuation();
+          } else {
+            continuation(task_state->result());
+          }
+        }, Qt::QueuedConnection);
+      };
+      state->onFinished(deliver);
     }
 
-  signals:
-    void finished();
+  private:
+    QSharedPointer<TaskState<T>> state;
   };
 
+  template<class Function, class T>
+  class TaskRunnable : public QRunnable {
+  public:
+    TaskRunnable(Function function,
+                 const QSharedPointer<TaskState<T>>& state)
+      : function(std::move(function)), state(state) {}
+
+    void run() override {
+      if constexpr (std::is_void_v<T>) {
+        std::invoke(function);
+        state->finish({});
+      } else {
+        state->finish(std::invoke(function));
+      }
+    }
 
+  private:
+    Function function;
+    QSharedPointer<TaskState<T>> state;
+  };
 
+  // All background work shares the global pool, so concurrent jobs do not
+  // oversubscribe the cores
   template<class Function>
-  void ThreadRunner(Function&& func, QObject* parent = nullptr) {
-    auto thread = new QThread(parent);
-    auto worker = new ThreadWorker(parent);
-    worker->moveToThread(thread);
-    QObject::connect(thread, &QThread::started, worker, [worker, func] {
-      worker->run(func);
-    });
-    QObject::connect(worker, &ThreadWorker::finished, thread, &QThread::quit);
-    QObject::connect(worker, &ThreadWorker::finished,
-                     worker, &ThreadWorker::deleteLater);
-    QObject::connect(thread, &QThread::finished, thread, &QThread::deleteLater);
-
-    thread->start();
+  auto run(Function&& function, Priority priority = Priority::NORMAL) {
+    using T = std::invoke_result_t<std::decay_t<Function>>;
+    auto state = QSharedPointer<TaskState<T>>::create();
+    QThreadPool::globalInstance()->start(
+          new TaskRunnable<std::decay_t<Function>, T>(
+            std::forward<Function>(function), state),
+          static_cast<int>(priority));
+    return Task<T>(state);
+  }
+
+  // Runs the worker on up to worker_count threads of the global pool, the
+  // calling thread runs it too. The workers take their items from a shared
+  // counter and return once none is left, so a worker the busy pool has not
+  // started yet is run by the waiting thread and returns at once.
+  inline void runWorkers(int worker_count,
+                         const std::function<void ()>& worker) {
+    QFutureSynchronizer<void> synchronizer;
+    for (int i = 1; i < worker_count; ++i) {
+      synchronizer.addFuture(QtConcurrent::run(worker));
+    }
+    worker();
+    synchronizer.waitForFinished();
   }
 }
@@ -1,36 +1,14 @@
 #include "treemodel.h"
-#include "treeitem.h"
 
 #include <QFile>
 
 #include <QDebug>
 
 TreeModel::TreeModel(const QStringList& headers, QObject* parent)
-    : QAbstractItemModel(parent), headers(headers) {
-  QVector<QVariant> rootData;
-  for (auto header : headers) {
-    rootData << header;
-  }
-
-  root_item = new TreeItem(rootData);
-}
-
-TreeModel::TreeModel(const TreeModel &treeModel, QObject *parent)
-  : QAbstractItemModel(parent), headers(treeModel.headers) {
-  QVector<QVariant> rootData;
-  for (auto header : headers) {
-    rootData << header;
-  }
-
-  root_item = new TreeItem(*treeModel.root_item);
-}
-
-//TreeModel::~TreeModel() {
-//    delete rootItem;
-//}
+    : QAbstractItemModel(parent), headers(headers) {}
 
 int TreeModel::columnCount([[maybe_unused]] const QModelIndex& parent) const {
-  return root_item->columnCount();
+  return headers.size();
 }
 
 QVariant TreeModel::data(const QModelIndex& index, int role) const {
@@ -40,9 +18,7 @@ QVariant TreeModel::data(const QModelIndex& index, int role) const {
   if (role != Qt::DisplayRole && role != Qt::EditRole)
     return QVariant();
 
-  TreeItem* item = getItem(index);
-
-  return item->data(index.column());
+  return nodeData(getNode(index), index.column());
 }
 
 Qt::ItemFlags TreeModel::flags(const QModelIndex& index) const {
@@ -52,20 +28,25 @@ Qt::ItemFlags TreeModel::flags(const QModelIndex& index) const {
   return Qt::ItemIsEditable | QAbstractItemModel::flags(index);
 }
 
-TreeItem* TreeModel::getItem(const QModelIndex& index) const {
-  if (index.isValid()) {
-    auto item = static_cast<TreeItem*>(index.internalPointer());
-    if (item)
-      return item;
-  }
-  return root_item;
+DbidTree::Node TreeModel::getNode(const QModelIndex& index) const {
+  if (index.isValid())
+    return static_cast<DbidTree::Node>(index.internalId());
+  return DbidTree::root;
+}
+
+QVariant TreeModel::nodeData(DbidTree::Node node, int column) const {
+  if (column == 0)
+    return edits.parameter(*dbid_tree, node);
+  if (column == 1)
+    return edits.value(*dbid_tree, node);
+  return QVariant();
 }
 
 QVariant TreeModel::headerData(int section,
                                Qt::Orientation orientation,
                                int role) const {
   if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
-    return root_item->data(section);
+    return headers.value(section);
 
   return QVariant();
 }
@@ -76,339 +57,246 @@ QModelIndex TreeModel::index(int row,
   if (parent.isValid() && parent.column() != 0)
     return QModelIndex();
 
-  auto parent_item = getItem(parent);
-
-  auto child_item = parent_item->child(row);
-  if (child_item)
-    return createIndex(row, column, child_item);
-  else
+  if (row < 0 || row >= rowCount(parent)
+      || column < 0 || column >= columnCount(parent))
     return QModelIndex();
-}
-
-bool TreeModel::insertColumns(int position,
-                              int columns,
-                              const QModelIndex& parent) {
-  bool success;
 
-  beginInsertColumns(parent, position, position + columns - 1);
-  success = root_item->insertColumns(position, columns);
-  endInsertColumns();
-
-  return success;
-}
-
-bool TreeModel::insertRows(int position, int rows, const QModelIndex& parent) {
-  auto parent_item = getItem(parent);
-  bool success;
-
-  beginInsertRows(parent, position, position + rows - 1);
-  success = parent_item->insertChildren(position,
-                                        rows,
-                                        root_item->columnCount());
-  endInsertRows();
-
-  return success;
+  auto child_node = dbid_tree->child(getNode(parent), row);
+  return createIndex(row, column, static_cast<quintptr>(child_node));
 }
 
 QModelIndex TreeModel::parent(const QModelIndex& index) const {
   if (!index.isValid())
     return QModelIndex();
 
-  auto child_item = getItem(index);
-  auto parent_item = child_item->parent();
+  auto parent_node = dbid_tree->parent(getNode(index));
 
-  if (parent_item == root_item)
+  if (parent_node == DbidTree::root)
     return QModelIndex();
 
-  return createIndex(parent_item->childNumber(), 0, parent_item);
+  return createIndex(dbid_tree->row(parent_node),
+                     0,
+                     static_cast<quintptr>(parent_node));
 }
 
-bool TreeModel::removeColumns(int position,
-                              int columns,
-                              const QModelIndex& parent) {
-  bool success;
+int TreeModel::rowCount(const QModelIndex& parent) const {
+  if (!dbid_tree || (parent.isValid() && parent.column() != 0))
+    return 0;
 
-  beginRemoveColumns(parent, position, position + columns - 1);
-  success = root_item->removeColumns(position, columns);
-  endRemoveColumns();
+  auto parent_node = getNode(parent);
+  if (!fetched_nodes.contains(parent_node))
+    return 0;
 
-  if (root_item->columnCount() == 0)
-    removeRows(0, rowCount());
+  return dbid_tree->childCount(parent_node);
+}
+
+bool TreeModel::hasChildren(const QModelIndex& parent) const {
+  if (!dbid_tree || (parent.isValid() && parent.column() != 0))
+    return false;
 
-  return success;
+  return dbid_tree->childCount(getNode(parent)) > 0;
 }
 
-bool TreeModel::removeRows(int position, int rows, const QModelIndex& parent) {
-  auto parent_item = getItem(parent);
-  bool success = true;
+bool TreeModel::canFetchMore(const QModelIndex& parent) const {
+  return hasChildren(parent) && !fetched_nodes.contains(getNode(parent));
+}
 
-  beginRemoveRows(parent, position, position + rows - 1);
-  success = parent_item->removeChildren(position, rows);
-  endRemoveRows();
+// The children are rows of the shared tree, fetching them only makes them
+// visible, nothing is copied
+void TreeModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent))
+    return;
 
-  return success;
+  auto parent_node = getNode(parent);
+  beginInsertRows(parent, 0, dbid_tree->childCount(parent_node) - 1);
+  fetched_nodes.insert(parent_node);
+  endInsertRows();
 }
 
-void TreeModel::loadFromDbidTree(Loader::DbidTreeItem* dbid_root_item) {
+void TreeModel::loadFromDbidTree(
+    QSharedPointer<const DbidTree> dbid_tree,
+    QSharedPointer<const PlantTopology> plant_topology) {
   emit updateStatus("Создание дерева DBID. Подождите...");
   beginResetModel();
-  delete root_item;
-  QVector<QVariant> rootData;
-  for(const auto& header : headers)
-    rootData << header;
-
-  root_item = new TreeItem(rootData);
-  std::function<void (TreeItem*, Loader::DbidTreeItem*)> readItem =
-          [this, &readItem](TreeItem* current_item,
-                            Loader::DbidTreeItem* dbid_item) {
-    if (current_item != root_item) {
-      current_item->setData(0, dbid_item->parameter);
-      current_item->setData(1, dbid_item->value);
-    }
-    int row = 0;
-    for (auto childDbidItem : dbid_item->children) {
-      current_item->insertChildren(row, 1, 2);
-      readItem(current_item->child(row), childDbidItem);
-      ++row;
-    }
-  };
-  readItem(root_item, dbid_root_item);
+  this->dbid_tree = dbid_tree;
+  this->plant_topology = plant_topology;
+  fetched_nodes.clear();
+  edits.clear();
   endResetModel();
   emit updateStatus("Создание дерева DBID. Подождите... Завершено");
 }
 
 QPair<QVariant, QVariant>
 TreeModel::getNameValue(int row,const QModelIndex& parent) const {
-  auto item = getItem(parent);
-  return {item->child(row)->data(0), item->child(row)->data(1)};
+  auto node = dbid_tree->child(getNode(parent), row);
+  return {nodeData(node, 0), nodeData(node, 1)};
 }
 
-void TreeModel::soeCheck()
+DbidPatch TreeModel::soeCheck() const
 {
-  auto getItem
-      = [](TreeItem* item, const QPair<QString, QString>& data) -> TreeItem* {
-    for (int i = 0; i < item->childCount(); ++i) {
-      auto child = item->child(i);
-      if (child->data(0).toString().startsWith(data.first)
-          && child->data(1).toString().startsWith(data.second)) {
-        return child;
-      }
-    }
-    return nullptr;
-  };
-
-  auto getItems
-      = [](TreeItem* item, const QPair<QString, QString>& data)
-      -> QList<TreeItem*> {
-    QList<TreeItem*> list;
-    for (int i = 0; i < item->childCount(); ++i) {
-      auto child = item->child(i);
-      if (child->data(0).toString().startsWith(data.first)
-          && child->data(1).toString().startsWith(data.second)) {
-        list.append(child);
-      }
-    }
-    return list;
+  DbidPatch patch;
+  if (!plant_topology) {
+    return patch;
+  }
+  // Parameters are found by the child index of the DBID, their values are
+  // read through the edits
+  auto value = [this](DbidTree::Node node) -> const QString& {
+    return edits.value(*dbid_tree, node);
   };
 
-  QMap<QString, QPair<TreeItem*, QList<TreeItem*>>> moduleStructures;
-
-  auto systemItem = getItem(root_item, {"", "System"});
-  Q_ASSERT(systemItem);
-  auto networkItem = getItem(systemItem, {"", "Network"});
-  Q_ASSERT(networkItem);
-  auto unitItem = getItem(networkItem, {"UNIT", "Unit"});
-  Q_ASSERT(unitItem);
-  auto dropItems = getItems(unitItem, {"DROP", "Drop"});
-  Q_ASSERT(!dropItems.isEmpty());
-  for (auto dropItem : dropItems) {
-    QRegularExpression rx("DROP(\\d{2})/DROP\\d{2}");
-    auto match = rx.match(dropItem->data(0).toString());
-    if (match.hasMatch()) {
-      auto dropNumber = match.captured(1);
-      auto ioDeviceItem = getItem(dropItem, {"I/O Device 0 IOIC", "IoDevice"});
-      Q_ASSERT(ioDeviceItem);
-      auto ioInterfaceItems
-          = getItems(ioDeviceItem, {"I/O Interface", "IoDevice"});
-      Q_ASSERT(!ioInterfaceItems.isEmpty());
-      for (auto ioInterfaceItem : ioInterfaceItems) {
-        auto interfaceNumber
-            = ioInterfaceItem
-              ->data(0).toString().mid(QString("I/O Interface ").length(), 1);
-        if (interfaceNumber == "1" || interfaceNumber == "2") {
-          auto branchItems = getItems(ioInterfaceItem, {"Branch", "Branch"});
-          if (!branchItems.isEmpty()) {
-            for (auto branchItem : branchItems) {
-              auto branchNumber
-                  = branchItem
-                    ->data(0).toString().mid(QString("Branch ").length(), 1);
-              auto slotItems = getItems(branchItem, {"Slot", "RSlot"});
-              Q_ASSERT(!slotItems.isEmpty());
-              for (auto slotItem : slotItems) {
-                auto slotNumber
-                    = slotItem
-                      ->data(0).toString().mid(QString("Slot ").length(), 1);
-                auto moduleItem = getItem(slotItem, {"", "RModule"});
-                if (moduleItem) {
-                  auto moduleReference = (QStringList()
-                                          << dropNumber
-                                          << interfaceNumber
-                                          << branchNumber
-                                          << slotNumber).join('.');
-                  moduleStructures.insert(moduleReference, {moduleItem, {}});
-                }
-              }
-            }
-          }
+  auto& string_pool = StringPool::instance();
+  const auto& topology = *plant_topology;
+  QVector<uint> eventTaggingEnable(topology.moduleCount());
+  for (PlantTopology::Id drop = 0; drop < topology.dropCount(); ++drop) {
+    for (auto pointNode : topology.drop(drop).digital_points) {
+      auto ioLocationNode = dbid_tree->findChild(pointNode, "IO_LOCATION");
+      if (ioLocationNode != DbidTree::null) {
+        auto ioChannelNode = dbid_tree->findChild(pointNode, "IO_CHANNEL");
+        Q_ASSERT(ioChannelNode != DbidTree::null);
+        auto module = topology.findModule(
+              drop, string_pool.find(value(ioLocationNode)));
+        Q_ASSERT(module != PlantTopology::null);
+        if (module == PlantTopology::null) {
+          continue;
         }
-      }
-      auto pointItems
-          = getItems(dropItem,
-                     {"", PointInfo::toString(PointInfo::Type::DigitalPoint)});
-      for (auto pointItem : pointItems) {
-        auto ioLocationItem = getItem(pointItem, {"IO_LOCATION", ""});
-        if (ioLocationItem) {
-          Q_ASSERT(getItem(pointItem, {"IO_CHANNEL", ""}));
-          auto ioLocation = ioLocationItem->data(1).toString();
-          auto moduleReference
-              = (QStringList() << dropNumber << ioLocation).join('.');
-          Q_ASSERT(moduleStructures.contains(moduleReference));
-          moduleStructures[moduleReference].second.append(pointItem);
+        auto soePointNode = dbid_tree->findChild(pointNode, "SOE_POINT");
+        auto soeEnabledNode = dbid_tree->findChild(pointNode, "SOE_ENABLED");
+        if (soePointNode != DbidTree::null
+            && soeEnabledNode != DbidTree::null) {
+          if (value(soePointNode) == value(soeEnabledNode)
+              && value(soePointNode) == "1") {
+            auto ioChannel = value(ioChannelNode);
+            eventTaggingEnable[module] |= 1 << (ioChannel.toInt() - 1);
+          }
         }
       }
     }
   }
 
-  for (auto structure : moduleStructures) {
-    auto key = moduleStructures.key(structure);
-//    if (key == "28.1.3.8") {
-//      qDebug() << key;
-//    }
-    auto moduleItem = structure.first;
-    auto pointItems = structure.second;
-    uint uEventTaggingEnable = 0;
-    for (auto pointItem : pointItems) {
-//      if (key == "28.1.3.8") {
-//        qDebug() << pointItem->data(0);
-//      }
-      auto soePointItem = getItem(pointItem, {"SOE_POINT", ""});
-      auto soeEnabledItem = getItem(pointItem, {"SOE_ENABLED", ""});
-      if (soePointItem && soeEnabledItem) {
-        if (soePointItem->data(1) == soeEnabledItem->data(1)
-            && soePointItem->data(1) == "1") {
-          auto ioChannel
-              = getItem(pointItem, {"IO_CHANNEL", ""})->data(1).toString();
-          uEventTaggingEnable |= 1 << (ioChannel.toInt() - 1);
-        }
-      }
-//      if (key == "28.1.3.8") {
-//        qDebug() << uEventTaggingEnable;
-//      }
-    }
-    auto eventTaggingEnabledItem
-        = getItem(moduleItem, {"EVENT_TAGGING_ENABLE", ""});
+  for (PlantTopology::Id module = 0;
+       module < topology.moduleCount();
+       ++module) {
+    auto moduleNode = topology.module(module).node;
+    auto eventTaggingEnableNode
+        = dbid_tree->findChild(moduleNode, "EVENT_TAGGING_ENABLE");
     QString qsEventTaggingEnable
-        = "0x" + QString::number(uEventTaggingEnable, 16)
+        = "0x" + QString::number(eventTaggingEnable[module], 16)
                  .rightJustified(4, '0');
-    if (eventTaggingEnabledItem) {
-      eventTaggingEnabledItem->setData(1, qsEventTaggingEnable);
+    if (eventTaggingEnableNode != DbidTree::null) {
+      patch.setValue(eventTaggingEnableNode, qsEventTaggingEnable);
     } else {
-      moduleItem->insertChildren(moduleItem->childCount(), 1, 2);
-      eventTaggingEnabledItem = moduleItem->child(moduleItem->childCount() - 1);
-      eventTaggingEnabledItem->setData(0, "EVENT_TAGGING_ENABLE");
-      eventTaggingEnabledItem->setData(1, qsEventTaggingEnable);
+      patch.appendParameter(moduleNode,
+                            "EVENT_TAGGING_ENABLE",
+                            qsEventTaggingEnable);
     }
-
   }
+  return patch;
 }
 
-void TreeModel::saveDbid(const QString &path)
+TreeModel::DbidSnapshot TreeModel::dbidSnapshot() const {
+  DbidSnapshot snapshot{dbid_tree, edits};
+  snapshot.patch.merge(soeCheck());
+  return snapshot;
+}
+
+bool TreeModel::saveDbid(const QString &path, const DbidSnapshot& snapshot)
 {
-  auto model = new TreeModel(*this);
-  model->soeCheck();
-  QString data;
-  data += "OVPT_FORMAT=2.1\n";
+  QFile output(path);
+  if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    emit updateStatus("Не удалось сохранить DBID: " + path);
+    return false;
+  }
 
-  auto offset = [](int depth) -> QString {
-    QString offset;
-    for (int i = 0; i < depth; ++i) {
-      offset += " ";
+  // The tree is written as it is walked with the edits and the SOE
+  // corrections applied, only a small buffer is kept in memory. The file
+  // keeps the encoding of the DBID it has been read from.
+  auto encoding = snapshot.tree ? snapshot.tree->encoding()
+                                : MappedFile::Encoding::LOCAL_8BIT;
+  QByteArray buffer;
+  if (encoding == MappedFile::Encoding::UTF8) {
+    buffer += "\xEF\xBB\xBF";
+  }
+  auto write = [&output, &buffer, encoding](const QString& data) {
+    buffer += MappedFile::encode(encoding, data);
+    if (buffer.size() > (1 << 20)) {
+      output.write(buffer);
+      buffer.clear();
     }
-    return offset;
   };
+  write("OVPT_FORMAT=2.1\n");
+  if (!snapshot.tree) {
+    return output.write(buffer) == buffer.size();
+  }
+  const auto& patch = snapshot.patch;
 
-  std::function<QString (TreeItem*, int)> objectToString
-      = [&objectToString, &offset](TreeItem* item,int depth) -> QString {
+  auto offset = [](int depth) -> QString {
+    return QString(depth, ' ');
+  };
 
-    QString data;
+  const auto& tree = *snapshot.tree;
+  std::function<void (DbidTree::Node, int)> writeObject
+      = [&writeObject, &write, &offset, &tree, &patch](DbidTree::Node node,
+                                                       int depth) {
+    const auto& appended = patch.appendedParameters(node);
+    auto childCount = tree.childCount(node);
     int i = 0;
     QStringList array;
-    for (; i < item->childCount() && item->child(i)->childCount() == 0; ++i) {
+    for (; i < childCount && tree.childCount(tree.child(node, i)) == 0; ++i) {
+      auto child = tree.child(node, i);
       array += QString("%1=\"%2\"")
-               .arg(item->child(i)->data(0).toString())
-               .arg(item->child(i)->data(1).toString());
+               .arg(patch.parameter(tree, child), patch.value(tree, child));
+    }
+    for (const auto& parameter : appended) {
+      array += QString("%1=\"%2\"").arg(parameter.name, parameter.value);
     }
 
-    QString children;
-    for (; i < item->childCount(); ++i) {
-      children += objectToString(item->child(i), depth + 1);
+    write(offset(depth) + "(TYPE=\"" + patch.value(tree, node)
+          + "\" NAME=\"" + patch.parameter(tree, node) + "\"\n"
+          + offset(depth + 1) + "["
+          + array.join('\n' + offset(depth + 1)) + "]\n");
+
+    for (; i < childCount; ++i) {
+      writeObject(tree.child(node, i), depth + 1);
     }
 
-    bool isLast
-        = item == item->parent()->child(item->parent()->childCount() - 1);
-    data += QString("%1(TYPE=\"%2\" NAME=\"%3\"\n%4[%5]\n%6%7)\n")
-           .arg(offset(depth))
-           .arg(item->data(1).toString())
-           .arg(item->data(0).toString())
-           .arg(offset(depth + 1))
-           .arg(array.join('\n' + offset(depth + 1)))
-           .arg(children)
-           .arg(offset((depth == 0 && !isLast) ? 1 : depth));
-
-    return data;
+    auto parent = tree.parent(node);
+    bool isLast = tree.row(node) == tree.childCount(parent) - 1;
+    write(offset((depth == 0 && !isLast) ? 1 : depth) + ")\n");
   };
 
-  for (int i = 0; i < model->root_item->childCount(); ++i) {
-    data += objectToString(model->root_item->child(i), 0);
+  for (int i = 0; i < tree.childCount(DbidTree::root); ++i) {
+    writeObject(tree.child(DbidTree::root, i), 0);
   }
-
-  QFile output(path);
-  output.open(QIODevice::WriteOnly | QIODevice::Text);
-
-  output.write(data.toLocal8Bit().toStdString().c_str());
-
+  output.write(buffer);
+  output.close();
+  return output.error() == QFileDevice::NoError;
 }
 
 void TreeModel::clear() {
   beginResetModel();
-  delete root_item;
-  QVector<QVariant> rootData;
-  for(const auto& header : headers)
-    rootData << header;
-
-  root_item = new TreeItem(rootData);
+  dbid_tree.reset();
+  plant_topology.reset();
+  fetched_nodes.clear();
+  edits.clear();
   endResetModel();
 }
 
-int TreeModel::rowCount(const QModelIndex& parent) const {
-  auto parent_item = getItem(parent);
-
-  return parent_item->childCount();
-}
-
 bool TreeModel::setData(const QModelIndex& index,
                         const QVariant &value,
                         int role) {
-  if (role != Qt::EditRole)
+  if (role != Qt::EditRole || !index.isValid()
+      || index.column() >= columnCount())
     return false;
 
-  auto item = getItem(index);
-  bool result = item->setData(index.column(), value);
+  auto node = getNode(index);
+  if (index.column() == 0)
+    edits.setParameter(node, value.toString());
+  else
+    edits.setValue(node, value.toString());
 
-  if (result)
-    emit dataChanged(index, index, {role});
+  emit dataChanged(index, index, {role});
 
-  return result;
+  return true;
 }
 
 bool TreeModel::setData(const QModelIndex& index,
@@ -417,19 +305,15 @@ bool TreeModel::setData(const QModelIndex& index,
   if (role != Qt::EditRole)
     return false;
 
-  auto item = getItem(index);
   bool result = true;
   for (int i = 0; i < data.size(); ++i) {
-    if (!item->setData(index.column() + i, data)) {
+    if (!setData(this->index(index.row(), index.column() + i, index.parent()),
+                 data[i],
+                 role)) {
       result = false;
     }
   }
 
-  if (result)
-    emit dataChanged(index,
-                     this->index(index.row(), index.column() + data.size()),
-                     {role});
-
   return result;
 }
 
@@ -437,13 +321,12 @@ bool TreeModel::setHeaderData(int section,
                               Qt::Orientation orientation,
                               const QVariant& value,
                               int role) {
-  if (role != Qt::EditRole || orientation != Qt::Horizontal)
+  if (role != Qt::EditRole || orientation != Qt::Horizontal
+      || section < 0 || section >= headers.size())
     return false;
 
-  bool result = root_item->setData(section, value);
+  headers[section] = value.toString();
+  emit headerDataChanged(orientation, section, section);
 
-  if (result)
-    emit headerDataChanged(orientation, section, section);
-
-  return result;
+  return true;
 }
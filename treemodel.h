@@ -1,18 +1,20 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QSet>
 
+#include "dbidpatch.h"
 #include "loader.h"
 
-class TreeItem;
-
+// DBID tree shown straight from the parsed DbidTree, an index refers to its
+// node by the internal id. The children of a node are only reported once
+// the view fetches them, edits are kept in a patch over the shared tree.
 class TreeModel : public QAbstractItemModel {
   Q_OBJECT
 
 public:
   TreeModel(const QStringList &headers, QObject *parent = nullptr);
-  TreeModel(const TreeModel &treeModel, QObject *parent = nullptr);
-//  ~TreeModel();
 
   QVariant data(const QModelIndex& index, int role) const override;
   QVariant headerData(int section,
@@ -26,6 +28,9 @@ public:
 
   int rowCount(const QModelIndex& parent = QModelIndex()) const override;
   int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
 
   Qt::ItemFlags flags(const QModelIndex& index) const override;
   bool setData(const QModelIndex& index,
@@ -39,27 +44,24 @@ public:
                      const QVariant& value,
                      int role = Qt::EditRole) override;
 
-  bool insertColumns(int position,
-                     int columns,
-                     const QModelIndex& parent = QModelIndex()) override;
-  bool removeColumns(int position,
-                     int columns,
-                     const QModelIndex& parent = QModelIndex()) override;
-  bool insertRows(int position,
-                  int rows,
-                  const QModelIndex& parent = QModelIndex()) override;
-  bool removeRows(int position,
-                  int rows,
-                  const QModelIndex& parent = QModelIndex()) override;
-
-  void loadFromDbidTree(Loader::DbidTreeItem* dbid_root_item);
+  void loadFromDbidTree(QSharedPointer<const DbidTree> dbid_tree,
+                        QSharedPointer<const PlantTopology> plant_topology);
 
   QPair<QVariant, QVariant> getNameValue(int row,
                                          const QModelIndex& parent
                                            = QModelIndex()) const;
 
-  void soeCheck();
-  void saveDbid(const QString& path);
+  // The shared tree with the edits and the SOE corrections. It is taken on
+  // the thread of the model, the edits are only copied there.
+  struct DbidSnapshot {
+    QSharedPointer<const DbidTree> tree;
+    DbidPatch patch;
+  };
+  DbidSnapshot dbidSnapshot() const;
+
+  // Writes the snapshot, reads nothing else of the model so it can run in
+  // the background. false if the file could not be written.
+  bool saveDbid(const QString& path, const DbidSnapshot& snapshot);
 
   void clear();
 
@@ -68,8 +70,17 @@ signals:
   void updateProgress(int percent);
 
 private:
-  TreeItem* getItem(const QModelIndex& index) const;
+  DbidTree::Node getNode(const QModelIndex& index) const;
+  QVariant nodeData(DbidTree::Node node, int column) const;
+
+  // EVENT_TAGGING_ENABLE of every module recalculated from the SOE
+  // parameters of its points, as a patch over the edits
+  DbidPatch soeCheck() const;
 
-  TreeItem* root_item;
   QStringList headers;
+  QSharedPointer<const DbidTree> dbid_tree;
+  QSharedPointer<const PlantTopology> plant_topology;
+  // Nodes whose children have been fetched by a view
+  QSet<DbidTree::Node> fetched_nodes;
+  DbidPatch edits;
 };
@@ -0,0 +1,169 @@
+#include "wildcardmask.h"
+
+#include <algorithm>
+
+WildcardMask::WildcardMask(const QString& pattern) : pattern_(pattern) {
+  int pos = 0;
+  while (pos < pattern.size()) {
+    auto ch = pattern[pos];
+    if (ch == '*') {
+      // Consecutive stars match the same as one
+      if (tokens_.isEmpty() || tokens_.last().type != TokenType::STAR) {
+        tokens_.append({TokenType::STAR, QChar(), -1});
+      }
+      ++pos;
+      continue;
+    }
+    if (ch == '?') {
+      tokens_.append({TokenType::ANY, QChar(), -1});
+      ++pos;
+      continue;
+    }
+    if (ch == '[') {
+      // A ']' right after the opening bracket is a member of the set, an
+      // unclosed bracket is a plain character
+      CharSet set;
+      auto set_pos = pos + 1;
+      if (set_pos < pattern.size()
+          && (pattern[set_pos] == '!' || pattern[set_pos] == '^')) {
+        set.negated = true;
+        ++set_pos;
+      }
+      auto first = set_pos;
+      while (set_pos < pattern.size()
+             && (pattern[set_pos] != ']' || set_pos == first)) {
+        auto low = pattern[set_pos];
+        auto high = low;
+        if (set_pos + 2 < pattern.size()
+            && pattern[set_pos + 1] == '-'
+            && pattern[set_pos + 2] != ']') {
+          high = pattern[set_pos + 2];
+          set_pos += 2;
+        }
+        set.ranges.append({low, high});
+        ++set_pos;
+      }
+      if (set_pos < pattern.size()) {
+        tokens_.append({TokenType::SET, QChar(), sets_.size()});
+        sets_.append(set);
+        pos = set_pos + 1;
+        continue;
+      }
+    }
+    tokens_.append({TokenType::CHAR, ch, -1});
+    ++pos;
+  }
+  auto has_star = std::any_of(
+        tokens_.begin(), tokens_.end(), [](const Token& token) {
+    return token.type == TokenType::STAR;
+  });
+  if (!has_star) {
+    fixed_length_ = tokens_.size();
+  }
+}
+
+const QString& WildcardMask::pattern() const {
+  return pattern_;
+}
+
+bool WildcardMask::isEmpty() const {
+  return pattern_.isEmpty();
+}
+
+int WildcardMask::fixedLength() const {
+  return fixed_length_;
+}
+
+bool WildcardMask::matches(const QString& text) const {
+  if (fixed_length_ != -1) {
+    if (text.size() != fixed_length_) {
+      return false;
+    }
+    auto token = tokens_.constData();
+    auto ch = text.constData();
+    for (auto end = ch + fixed_length_; ch != end; ++ch, ++token) {
+      if (!matches(*token, *ch)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Greedy matching which returns to the last star on a mismatch, a star
+  // never has to be revisited once a later one has matched
+  auto size = text.size();
+  auto token_count = tokens_.size();
+  int token = 0;
+  int pos = 0;
+  int star = -1;
+  int star_pos = 0;
+  while (pos < size) {
+    if (token < token_count
+        && tokens_[token].type != TokenType::STAR
+        && matches(tokens_[token], text[pos])) {
+      ++token;
+      ++pos;
+    } else if (token < token_count
+               && tokens_[token].type == TokenType::STAR) {
+      star = token++;
+      star_pos = pos;
+    } else if (star != -1) {
+      token = star + 1;
+      pos = ++star_pos;
+    } else {
+      return false;
+    }
+  }
+  while (token < token_count && tokens_[token].type == TokenType::STAR) {
+    ++token;
+  }
+  return token == token_count;
+}
+
+QStringList WildcardMask::literals() const {
+  QStringList result;
+  QString literal;
+  for (const auto& token : tokens_) {
+    if (token.type == TokenType::CHAR) {
+      literal += token.ch;
+    } else if (!literal.isEmpty()) {
+      result.append(literal);
+      literal.clear();
+    }
+  }
+  if (!literal.isEmpty()) {
+    result.append(literal);
+  }
+  return result;
+}
+
+QString WildcardMask::prefix() const {
+  QString result;
+  for (const auto& token : tokens_) {
+    if (token.type != TokenType::CHAR) {
+      break;
+    }
+    result += token.ch;
+  }
+  return result;
+}
+
+bool WildcardMask::matches(const Token& token, QChar ch) const {
+  switch (token.type) {
+    case TokenType::CHAR:
+      return token.ch == ch;
+    case TokenType::ANY:
+      return true;
+    case TokenType::SET: {
+      const auto& set = sets_[token.set];
+      for (const auto& range : set.ranges) {
+        if (ch >= range.first && ch <= range.second) {
+          return !set.negated;
+        }
+      }
+      return set.negated;
+    }
+    case TokenType::STAR:
+      break;
+  }
+  return false;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QChar>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Mask in the QRegExp::Wildcard syntax matched against whole strings:
+// ? is any character, * is any number of characters, [abc], [a-z] and
+// [!abc] are character sets. The mask is parsed once, matching does not
+// allocate, so one mask can be shared by several threads. A mask without
+// stars, like the masks of the characteristics, is compared position by
+// position without backtracking.
+class WildcardMask {
+public:
+  WildcardMask(const QString& pattern = QString());
+
+  const QString& pattern() const;
+  bool isEmpty() const;
+  // Length of the matching strings, -1 if the mask has a star
+  int fixedLength() const;
+  bool matches(const QString& text) const;
+
+  // Runs of plain characters, every matching string contains all of them
+  QStringList literals() const;
+  // Plain characters before the first wildcard
+  QString prefix() const;
+
+private:
+  enum class TokenType {
+    CHAR, ANY, SET, STAR
+  };
+
+  struct Token {
+    TokenType type;
+    QChar ch;
+    int set;
+  };
+
+  struct CharSet {
+    QVector<QPair<QChar, QChar>> ranges;
+    bool negated = false;
+  };
+
+  bool matches(const Token& token, QChar ch) const;
+
+  QString pattern_;
+  QVector<Token> tokens_;
+  QVector<CharSet> sets_;
+  int fixed_length_ = -1;
+};